@@ -0,0 +1,308 @@
+#pragma once
+// Content-addressed blob index (header-only).
+// Finished downloads are registered by SHA-256 as references: digest -> the files that
+// hold it (path, size, mtime). Nothing is copied; the downloaded files are the content,
+// so the store costs no disk space. A later download of a digest that is still on disk
+// is materialized from one of its references by reflink (Linux FICLONE) or copy instead
+// of being fetched again.
+// References are counted per digest. A reference whose file vanished or changed (size or
+// mtime differ) is dropped when it is next used and by gc(); a digest without references
+// is forgotten together with its prefix entries.
+// A prefix index maps (sha256 of the first kPrefixBytes, total size) -> full hash so an
+// in-flight download can be recognized and skipped after its first megabyte.
+// Both live in <root>/blobs.idx (rewritten through a temp file on change), loaded on init().
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <system_error>
+#include <filesystem>
+
+#include "settings/helpers/fs_ops.hpp"
+
+namespace app {
+namespace blob_store {
+
+namespace fs = std::filesystem;
+
+inline constexpr std::uint64_t kPrefixBytes = 1024 * 1024;
+
+enum class Link {
+    Hard,    // shares the inode; fastest, but in-place writes affect every copy
+    Reflink, // copy-on-write clone where the filesystem supports it, else copy
+    Copy
+};
+
+// A file known to hold a blob, as it was when registered
+struct Ref {
+    std::string path;
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0; // file_time_type ticks
+};
+
+namespace detail {
+inline fs::path u8path(const std::string& s) {
+    return fs::path(std::u8string(s.begin(), s.end()));
+}
+
+inline std::string prefix_key(const std::string& prefix_hex, std::uint64_t size) {
+    return prefix_hex + ":" + std::to_string(size);
+}
+
+// Try a copy-on-write clone. Returns false if unsupported (caller falls back to copy).
+inline bool reflink(const fs::path& from, const fs::path& to) {
+#if defined(_WIN32)
+    (void)from; (void)to;
+    return false;
+#else
+    return app::settings::helpers::fs_ops::reflink_file(from.string(), to.string());
+#endif
+}
+
+// Current state of 'path' as a Ref; false if it is not a regular file
+inline bool stat(const std::string& path, Ref& out) {
+    std::error_code ec;
+    const fs::path p = u8path(path);
+    if (!fs::is_regular_file(p, ec)) return false;
+    const auto size = fs::file_size(p, ec);
+    if (ec) return false;
+    const auto mtime = fs::last_write_time(p, ec);
+    if (ec) return false;
+    out.path = path;
+    out.size = (std::uint64_t)size;
+    out.mtime = (std::int64_t)mtime.time_since_epoch().count();
+    return true;
+}
+
+// The file still holds what was registered
+inline bool still_valid(const Ref& r) {
+    Ref now;
+    return stat(r.path, now) && now.size == r.size && now.mtime == r.mtime;
+}
+} // namespace detail
+
+struct Store {
+    std::mutex m;
+    std::string root;
+    std::unordered_map<std::string, std::string> by_prefix; // "prefixhex:size" -> full hex
+    std::unordered_map<std::string, std::vector<Ref>> refs;  // full hex -> files holding it
+};
+
+inline Store& store() {
+    static Store s;
+    return s;
+}
+
+namespace detail {
+// Rewrite <root>/blobs.idx; caller holds store().m
+inline void save_locked() {
+    Store& s = store();
+    if (s.root.empty()) return;
+    const fs::path path = u8path(s.root) / "blobs.idx";
+    const fs::path tmp = fs::path(path).concat(".tmp");
+    {
+        std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+        if (!out.is_open()) return;
+        for (const auto& [key, hex] : s.by_prefix) out << "P\t" << key << '\t' << hex << '\n';
+        for (const auto& [hex, list] : s.refs) {
+            for (const auto& r : list) out << "R\t" << hex << '\t' << r.size << '\t' << r.mtime << '\t' << r.path << '\n';
+        }
+        if (!out) return;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+}
+
+// Forget 'hex' entirely once it has no references; caller holds store().m
+inline void drop_if_unreferenced_locked(const std::string& hex) {
+    Store& s = store();
+    auto it = s.refs.find(hex);
+    if (it != s.refs.end() && !it->second.empty()) return;
+    if (it != s.refs.end()) s.refs.erase(it);
+    for (auto p = s.by_prefix.begin(); p != s.by_prefix.end();) {
+        p = p->second == hex ? s.by_prefix.erase(p) : std::next(p);
+    }
+}
+
+// Remove the references of 'hex' that are no longer valid. Returns how many were dropped.
+inline std::size_t prune(const std::string& hex) {
+    std::vector<Ref> list;
+    {
+        std::lock_guard<std::mutex> lk(store().m);
+        auto it = store().refs.find(hex);
+        if (it == store().refs.end()) return 0;
+        list = it->second;
+    }
+    std::vector<std::string> stale;
+    for (const auto& r : list) {
+        if (!still_valid(r)) stale.push_back(r.path);
+    }
+    if (stale.empty()) return 0;
+    std::lock_guard<std::mutex> lk(store().m);
+    auto it = store().refs.find(hex);
+    if (it == store().refs.end()) return 0;
+    auto& v = it->second;
+    const std::size_t before = v.size();
+    v.erase(std::remove_if(v.begin(), v.end(), [&](const Ref& r){
+        return std::find(stale.begin(), stale.end(), r.path) != stale.end();
+    }), v.end());
+    const std::size_t dropped = before - v.size();
+    drop_if_unreferenced_locked(hex);
+    save_locked();
+    return dropped;
+}
+
+// A valid file holding 'hex', preferring one other than 'not_path'; empty if none
+inline std::string source_for(const std::string& hex, const std::string& not_path = {}) {
+    prune(hex);
+    std::lock_guard<std::mutex> lk(store().m);
+    auto it = store().refs.find(hex);
+    if (it == store().refs.end() || it->second.empty()) return {};
+    for (const auto& r : it->second) {
+        if (r.path != not_path) return r.path;
+    }
+    return it->second.front().path;
+}
+} // namespace detail
+
+inline bool enabled() {
+    std::lock_guard<std::mutex> lk(store().m);
+    return !store().root.empty();
+}
+
+// Drop references to files that vanished or changed, and digests left without any.
+// Returns the number of references dropped.
+inline std::size_t gc() {
+    std::vector<std::string> digests;
+    {
+        std::lock_guard<std::mutex> lk(store().m);
+        for (const auto& kv : store().refs) digests.push_back(kv.first);
+    }
+    std::size_t dropped = 0;
+    for (const auto& hex : digests) dropped += detail::prune(hex);
+    return dropped;
+}
+
+// Initialize the store under 'root' (created if missing), load the index and collect it.
+inline bool init(const std::string& root) {
+    if (root.empty()) return false;
+    std::error_code ec;
+    fs::create_directories(detail::u8path(root), ec);
+    if (!fs::is_directory(detail::u8path(root), ec)) return false;
+
+    {
+        std::lock_guard<std::mutex> lk(store().m);
+        Store& s = store();
+        s.root = root;
+        s.by_prefix.clear();
+        s.refs.clear();
+        std::ifstream in((detail::u8path(root) / "blobs.idx"), std::ios::in);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::vector<std::string> f;
+            std::size_t start = 0;
+            for (int i = 0; i < 4; ++i) {
+                const std::size_t tab = line.find('\t', start);
+                if (tab == std::string::npos) break;
+                f.push_back(line.substr(start, tab - start));
+                start = tab + 1;
+            }
+            f.push_back(line.substr(start)); // the path may contain anything but a newline
+            if (f.size() == 3 && f[0] == "P" && f[2].size() == 64) {
+                s.by_prefix[f[1]] = f[2];
+            } else if (f.size() == 5 && f[0] == "R" && f[1].size() == 64 && !f[4].empty()) {
+                Ref r;
+                r.path = f[4];
+                r.size = std::strtoull(f[2].c_str(), nullptr, 10);
+                r.mtime = std::strtoll(f[3].c_str(), nullptr, 10);
+                s.refs[f[1]].push_back(std::move(r));
+            }
+        }
+    }
+    gc();
+    return true;
+}
+
+// Number of valid files holding 'hex'
+inline std::size_t references(const std::string& hex) {
+    detail::prune(hex);
+    std::lock_guard<std::mutex> lk(store().m);
+    auto it = store().refs.find(hex);
+    return it == store().refs.end() ? 0 : it->second.size();
+}
+
+inline bool has(const std::string& hex) { return references(hex) > 0; }
+
+// Full hash of a blob whose first kPrefixBytes hash to prefix_hex and whose size is 'size'.
+// Only returns hashes that are still on disk.
+inline std::string lookup_prefix(const std::string& prefix_hex, std::uint64_t size) {
+    std::string hex;
+    {
+        std::lock_guard<std::mutex> lk(store().m);
+        auto it = store().by_prefix.find(detail::prefix_key(prefix_hex, size));
+        if (it == store().by_prefix.end()) return {};
+        hex = it->second;
+    }
+    return has(hex) ? hex : std::string();
+}
+
+// Register 'path' as holding blob 'hex' (hashes computed while downloading). Nothing is
+// copied; the reference lasts while the file keeps its size and mtime.
+inline bool adopt(const std::string& path, const std::string& hex, const std::string& prefix_hex, std::uint64_t size) {
+    Ref r;
+    if (hex.size() != 64 || !detail::stat(path, r) || r.size != size) return false;
+    std::lock_guard<std::mutex> lk(store().m);
+    if (store().root.empty()) return false;
+    auto& list = store().refs[hex];
+    list.erase(std::remove_if(list.begin(), list.end(), [&](const Ref& o){ return o.path == path; }), list.end());
+    list.push_back(std::move(r));
+    if (!prefix_hex.empty()) store().by_prefix[detail::prefix_key(prefix_hex, size)] = hex;
+    detail::save_locked();
+    return true;
+}
+
+// Place blob 'hex' at 'dest' from a file known to hold it (replacing an existing file)
+// and register 'dest' as another reference. Hard links only on explicit request.
+inline bool materialize(const std::string& hex, const std::string& dest, Link mode = Link::Reflink) {
+    const std::string src = detail::source_for(hex, dest);
+    if (src.empty()) return false;
+    if (src == dest) return true; // already there, unchanged
+    const fs::path from = detail::u8path(src);
+    const fs::path to = detail::u8path(dest);
+    std::error_code ec;
+    if (to.has_parent_path()) fs::create_directories(to.parent_path(), ec);
+    fs::remove(to, ec);
+
+    bool placed = false;
+    if (mode == Link::Hard) {
+        ec.clear();
+        fs::create_hard_link(from, to, ec);
+        placed = !ec;
+    }
+    if (!placed && mode != Link::Copy) placed = detail::reflink(from, to);
+    if (!placed) {
+        ec.clear();
+        fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec);
+        placed = !ec;
+    }
+    if (!placed) return false;
+
+    Ref r;
+    if (!detail::stat(dest, r)) return false;
+    std::lock_guard<std::mutex> lk(store().m);
+    if (!store().root.empty()) {
+        auto& list = store().refs[hex];
+        list.erase(std::remove_if(list.begin(), list.end(), [&](const Ref& o){ return o.path == dest; }), list.end());
+        list.push_back(std::move(r));
+        detail::save_locked();
+    }
+    return true;
+}
+
+} // namespace blob_store
+} // namespace app
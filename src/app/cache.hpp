@@ -2,13 +2,34 @@
 // Port target: src/app/cache.rs
 // Purpose: Caching layer for metadata and images during downloads.
 // Simple header-only cache that stores files by key inside a cache directory.
-// Keys are mapped to filenames by a safe encode (non-alnum -> '_') to avoid path issues.
+// Keys are hashed (SHA-256 truncated to 128 bits) and stored as <root>/ab/cd/<hash>, so
+// distinct keys never share a file and directories stay small. The original key is kept
+// in the index record and checked on get; entries without one (found on disk rather than
+// written through this API) are never served. Payload files stay plain so callers can use
+// the returned path directly. Files from the old flat layout (sanitize_key names) are
+// moved into place the first time they are read.
+// Size, last access and write time of every entry are tracked in cache_index.hpp; when the total
+// exceeds the byte budget, least recently used entries are evicted on a background thread.
+// Small values go to the pack backend instead (cache_pack.hpp): one segment file for
+// many entries, looked up through a memory-mapped index, read back without copying.
+// Packed entries are indexed as "pack/<32 hex>" and count against the same budget.
 
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <cctype>
+#include <cstdint>
+#include <atomic>
+#include <system_error>
+#include <filesystem>
+#include <fstream>
+#include <span>
 
 #include "settings/helpers/fs_ops.hpp"
+#include "cache_index.hpp"
+#include "cache_pack.hpp"
+#include "runtime.hpp"
+#include "hash.hpp"
 
 #if defined(_WIN32)
 #  include <windows.h>
@@ -22,6 +43,49 @@ inline std::string& cache_root_mut() {
     return root;
 }
 
+// Evict down to this fraction of the budget so eviction does not run on every put
+inline constexpr double kEvictLowWatermark = 0.9;
+
+inline Index& index() {
+    static Index idx;
+    return idx;
+}
+
+inline pack::Store& packs() {
+    static pack::Store store;
+    return store;
+}
+
+inline std::atomic<std::uint64_t>& budget_mut() {
+    static std::atomic<std::uint64_t> bytes{0}; // 0 = unlimited
+    return bytes;
+}
+
+inline std::atomic<bool>& evicting_mut() {
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+// Relative storage name for a key: "ab/cd/<32 hex>"
+inline std::string hashed_name(const std::string& key) {
+    hash::Sha256 h;
+    h.update(key);
+    const hash::Digest d = h.finish();
+    const std::string hex = hash::to_hex(d.data(), 16);
+    return hex.substr(0, 2) + "/" + hex.substr(2, 2) + "/" + hex;
+}
+
+// Index name (and pack store key) of a packed entry: "pack/<32 hex>"
+inline std::string packed_name(const std::string& key) {
+    hash::Sha256 h;
+    h.update(key);
+    const hash::Digest d = h.finish();
+    return "pack/" + hash::to_hex(d.data(), 16);
+}
+
+inline bool is_packed_name(const std::string& name) { return name.rfind("pack/", 0) == 0; }
+
+// Legacy flat-layout name; only used to migrate entries written by older builds
 inline std::string sanitize_key(const std::string& key) {
     std::string out;
     out.reserve(key.size());
@@ -61,21 +125,135 @@ inline bool remove_file_win(const std::string& path) {
 }
 #endif
 
-// Initialize cache directory, creating it if necessary.
+inline std::string join_root(const std::string& name) {
+    std::string p = cache_root_mut();
+    if (!p.empty() && p.back() != '/' && p.back() != '\\') p += '/';
+    p += name;
+    return p;
+}
+
+inline std::filesystem::path u8path(const std::string& s) {
+    return std::filesystem::path(std::u8string(s.begin(), s.end()));
+}
+
+// Top-level folders of the cache root that belong to other stores and are never evicted:
+// the pack backend, the thumbnail store and the download blob store
+inline bool is_store_dir(const std::filesystem::path& name) {
+    return name == "packs" || name == "thumbs" || name == "blobs";
+}
+
+// Bring the index in line with the directory: files it does not list (written before the
+// index existed, or whose records were lost in a crash) are registered so they can be
+// evicted, and entries whose files are gone are dropped so they stop counting against
+// the budget. Adopted files have no origin, so get() never serves them.
+inline void reconcile_with_disk() {
+    std::unordered_set<std::string> on_disk;
+    std::error_code ec;
+    const auto root = u8path(cache_root_mut());
+    auto it = std::filesystem::recursive_directory_iterator(root, ec);
+    for (auto end = std::filesystem::recursive_directory_iterator(); !ec && it != end; it.increment(ec)) {
+        // Stores kept under the cache folder manage their own files (packs/, thumbs/, blobs/)
+        if (it->is_directory(ec) && it.depth() == 0 && is_store_dir(it->path().filename())) {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(ec)) continue;
+        auto u = std::filesystem::relative(it->path(), root, ec).generic_u8string();
+        std::string name(u.begin(), u.end());
+        if (ec || name.rfind("cache.idx", 0) == 0) { ec.clear(); continue; }
+        auto size = it->file_size(ec);
+        if (ec) { ec.clear(); continue; }
+        on_disk.insert(name);
+        index().on_adopt(name, (std::uint64_t)size);
+    }
+    if (ec) return; // incomplete walk: do not drop entries we may simply not have reached
+    for (const auto& name : index().keys()) {
+        if (!is_packed_name(name) && !on_disk.count(name)) index().on_remove(name);
+    }
+}
+
+// Delete least recently used entries until the total is under the low watermark.
+inline void evict_now() {
+    const std::uint64_t budget = budget_mut().load();
+    if (budget == 0 || index().total_bytes() <= budget) return;
+    auto victims = index().take_victims((std::uint64_t)((double)budget * kEvictLowWatermark));
+    bool packed = false;
+    for (const auto& v : victims) {
+        if (is_packed_name(v.key)) {
+            packed |= packs().remove(v.key);
+            continue;
+        }
+        // Indexes written by older builds may have adopted store files; drop those entries only
+        const auto slash = v.key.find('/');
+        if (slash != std::string::npos && is_store_dir(u8path(v.key.substr(0, slash)))) continue;
+        remove_file_win(join_root(v.key));
+    }
+    // Removing from a pack only marks records dead; compaction returns the space
+    if (packed) packs().compact();
+}
+
+// Kick off background eviction if over budget (at most one eviction pass at a time).
+inline void maybe_evict() {
+    const std::uint64_t budget = budget_mut().load();
+    if (budget == 0 || index().total_bytes() <= budget) return;
+    if (evicting_mut().exchange(true)) return;
+    app::runtime::schedule([]{
+        evict_now();
+        evicting_mut() = false;
+    });
+}
+
+// Byte budget for the whole cache (0 = unlimited). Takes effect immediately.
+inline void set_budget(std::uint64_t bytes) {
+    budget_mut() = bytes;
+    maybe_evict();
+}
+
+inline std::uint64_t total_bytes() { return index().total_bytes(); }
+
+// Initialize cache directory, creating it if necessary, and load its index.
 inline bool init(const std::string& cache_dir) {
     cache_root_mut() = cache_dir;
     if (cache_root_mut().empty()) return false;
-    return app::settings::helpers::fs_ops::ensure_dir(cache_root_mut());
+    if (!app::settings::helpers::fs_ops::ensure_dir(cache_root_mut())) return false;
+    index().open(join_root("cache.idx"));
+    reconcile_with_disk();
+    maybe_evict();
+    if (packs().open(join_root("packs"))) {
+        app::runtime::schedule([]{ packs().compact(); });
+    }
+    return true;
 }
 
 // Compute absolute path for a cached key
 inline std::string path_for(const std::string& key) {
     if (cache_root_mut().empty()) return std::string();
-    std::string fname = sanitize_key(key);
-    std::string p = cache_root_mut();
-    if (!p.empty() && p.back() != '/' && p.back() != '\\') p += '/';
-    p += fname;
-    return p;
+    return join_root(hashed_name(key));
+}
+
+inline bool ensure_parent(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::create_directories(u8path(path).parent_path(), ec);
+    return !ec;
+}
+
+// Move an entry from the old flat layout to its hashed location. Returns true if moved.
+inline bool migrate_legacy(const std::string& key, const std::string& dst) {
+    const std::string legacy_name = sanitize_key(key);
+    const std::string legacy = join_root(legacy_name);
+    if (!file_exists(legacy) || !ensure_parent(dst)) return false;
+    std::error_code ec;
+    std::filesystem::rename(u8path(legacy), u8path(dst), ec);
+    if (ec) return false;
+    index().on_remove(legacy_name);
+    auto size = std::filesystem::file_size(u8path(dst), ec);
+    index().on_put(hashed_name(key), ec ? 0 : (std::uint64_t)size, std::time(nullptr), key);
+    return true;
+}
+
+// A packed copy would shadow a new file entry on read
+inline void drop_packed(const std::string& key) {
+    if (packs().remove(packed_name(key))) index().on_remove(packed_name(key));
 }
 
 // Put: copy a file from data_path into cache under key
@@ -83,15 +261,132 @@ inline bool put(const std::string& key, const std::string& data_path) {
     if (cache_root_mut().empty()) return false;
     std::string dst = path_for(key);
     if (dst.empty()) return false;
-    // Ensure root exists
-    if (!app::settings::helpers::fs_ops::ensure_dir(cache_root_mut())) return false;
-    return app::settings::helpers::fs_ops::copy_file(data_path, dst);
+    // Ensure the fan-out directory exists
+    if (!ensure_parent(dst)) return false;
+    if (!app::settings::helpers::fs_ops::copy_file(data_path, dst)) return false;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(u8path(dst), ec);
+    index().on_put(hashed_name(key), ec ? 0 : (std::uint64_t)size, std::time(nullptr), key);
+    drop_packed(key);
+    maybe_evict();
+    return true;
+}
+
+// Insert an existing file without copying its bytes when possible: rename (same volume),
+// else reflink / in-kernel copy. The source is consumed unless keep_source, in which case
+// the entry gets its own data (reflink or copy, never a hardlink) so later writes by the
+// caller cannot change what the cache serves.
+inline bool put_move(const std::string& key, const std::string& src_path, bool keep_source = false) {
+    if (cache_root_mut().empty()) return false;
+    std::string dst = path_for(key);
+    if (dst.empty() || !ensure_parent(dst)) return false;
+    const auto from = u8path(src_path);
+    const auto to = u8path(dst);
+    std::error_code ec;
+    bool placed = false;
+    if (!keep_source) {
+        std::filesystem::rename(from, to, ec);
+        placed = !ec;
+    }
+    if (!placed) placed = app::settings::helpers::fs_ops::copy_file(src_path, dst);
+    if (!placed) return false;
+    if (!keep_source) {
+        ec.clear();
+        if (std::filesystem::exists(from, ec)) std::filesystem::remove(from, ec);
+    }
+    ec.clear();
+    auto size = std::filesystem::file_size(to, ec);
+    index().on_put(hashed_name(key), ec ? 0 : (std::uint64_t)size, std::time(nullptr), key);
+    drop_packed(key);
+    maybe_evict();
+    return true;
 }
 
-// Get: return path to cached file if exists, else empty string
-inline std::string get(const std::string& key) {
+// Insert in-memory data (e.g. an HTTP response body) without a caller-side temp file.
+// Written next to the final location and renamed into place, so readers never see a partial file.
+inline bool put_bytes(const std::string& key, std::span<const std::uint8_t> data) {
+    if (cache_root_mut().empty()) return false;
+    std::string dst = path_for(key);
+    if (dst.empty() || !ensure_parent(dst)) return false;
+    const auto to = u8path(dst);
+    auto tmp = to;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write((const char*)data.data(), (std::streamsize)data.size());
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, to, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    index().on_put(hashed_name(key), (std::uint64_t)data.size(), std::time(nullptr), key);
+    drop_packed(key);
+    maybe_evict();
+    return true;
+}
+
+// Get: return path to cached file if exists, else empty string.
+// 'written' receives the unix time the entry was stored (0 if unknown).
+inline std::string get(const std::string& key, std::int64_t* written = nullptr) {
+    if (written) *written = 0;
     std::string p = path_for(key);
-    if (!p.empty() && file_exists(p)) return p;
+    if (p.empty()) return {};
+    const std::string name = hashed_name(key);
+    Index::Hit hit;
+    const bool indexed = index().on_get(name, &hit);
+    if (indexed && hit.origin == key) {
+        if (file_exists(p)) {
+            if (written) *written = hit.written;
+            return p;
+        }
+        index().on_remove(name); // deleted behind our back
+        return {};
+    }
+    if (indexed && !hit.origin.empty()) return {}; // another key's bytes (128-bit collision)
+    if (indexed || file_exists(p)) {
+        // No recorded origin (adopted, or on disk but unknown to the index): the bytes may
+        // belong to any key, so drop them and let the caller fetch again
+        index().on_remove(name);
+        remove_file_win(p);
+    }
+    return migrate_legacy(key, p) ? p : std::string();
+}
+
+// Put into the pack backend (no per-entry file). Replaces a file entry for the same key.
+inline bool put_packed(const std::string& key, std::span<const std::uint8_t> data) {
+    if (cache_root_mut().empty()) return false;
+    const std::string name = packed_name(key);
+    if (!packs().put(name, data)) return false;
+    index().on_put(name, (std::uint64_t)data.size(), std::time(nullptr), key);
+    const std::string p = path_for(key);
+    if (file_exists(p)) {
+        index().on_remove(hashed_name(key));
+        remove_file_win(p);
+    }
+    maybe_evict();
+    return true;
+}
+
+// Zero-copy read from the pack backend; empty View if absent.
+// 'written' receives the unix time the entry was stored (0 if unknown).
+inline pack::View get_packed(const std::string& key, std::int64_t* written = nullptr) {
+    if (written) *written = 0;
+    const std::string name = packed_name(key);
+    pack::View v = packs().get(name);
+    Index::Hit hit;
+    const bool indexed = index().on_get(name, &hit);
+    if (indexed && hit.origin == key && v) {
+        if (written) *written = hit.written;
+        return v;
+    }
+    if (indexed && !hit.origin.empty() && v) return {}; // another key's bytes
+    // Evicted or lost, or present without a recorded origin (e.g. index lost): unverifiable
+    if (indexed) index().on_remove(name);
+    if (v) packs().remove(name);
     return {};
 }
 
@@ -99,6 +394,14 @@ inline std::string get(const std::string& key) {
 inline bool remove(const std::string& key) {
     std::string p = path_for(key);
     if (p.empty()) return false;
+    packs().remove(packed_name(key));
+    index().on_remove(packed_name(key));
+    index().on_remove(hashed_name(key));
+    const std::string legacy_name = sanitize_key(key);
+    if (file_exists(join_root(legacy_name))) {
+        index().on_remove(legacy_name);
+        remove_file_win(join_root(legacy_name));
+    }
     if (!file_exists(p)) return true;
     return remove_file_win(p);
 }
@@ -0,0 +1,308 @@
+#pragma once
+// Size/recency index for app::cache (header-only).
+// Keeps key -> {size, last access, write time} in memory as an LRU list so the cache can enforce a
+// byte budget without stat'ing its directory. Persisted as an append-only log in
+// <cache_dir>/cache.idx, one record per line:
+//   A <key> <size> <atime> [<origin> [<written>]]   entry added or replaced; origin is the
+//                                                   caller's key, written the unix write time
+//   T <key> <atime>     touched (at most once per kTouchGranularity per key)
+//   D <key>             removed
+// Origins are escaped (\t \n \\); entry keys are relative paths and never need it.
+// Every record is flushed as it is appended, so a crash loses at most the line being
+// written. Load replays the log in O(records); the log is rewritten compactly when it
+// grows well past the number of live entries. A torn last line is ignored.
+
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <ctime>
+#include <system_error>
+#include <filesystem>
+
+namespace app {
+namespace cache {
+
+inline constexpr std::int64_t kTouchGranularity = 60;   // seconds between persisted touches
+inline constexpr std::size_t kIndexCompactMin = 1024;   // don't compact tiny logs
+
+class Index {
+public:
+    struct Victim {
+        std::string key;
+        std::uint64_t size = 0;
+    };
+
+    struct Hit {
+        std::string origin;
+        std::int64_t written = 0; // unix seconds; 0 = unknown
+    };
+
+    ~Index() { close(); }
+
+    // Replay the log at 'path' and open it for appending.
+    bool open(const std::string& path) {
+        std::lock_guard<std::mutex> lk(m_);
+        close_locked();
+        path_ = path;
+        entries_.clear();
+        lru_.clear();
+        total_ = 0;
+        replay_locked();
+        rewrite_locked();
+        file_ = std::fopen(path_.c_str(), "ab");
+        return file_ != nullptr;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(m_);
+        close_locked();
+    }
+
+    void on_put(const std::string& key, std::uint64_t size, std::int64_t now = std::time(nullptr),
+                const std::string& origin = std::string()) {
+        std::lock_guard<std::mutex> lk(m_);
+        set_locked(key, size, now, origin, now);
+        append_locked(add_record(key, entries_[key]));
+    }
+
+    // Register a file found on disk unless 'key' is already indexed. It has no origin and
+    // goes to the cold end of the LRU. Returns true if added.
+    bool on_adopt(const std::string& key, std::uint64_t size) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (entries_.count(key)) return false;
+        set_locked(key, size, 0, std::string(), 0);
+        auto& e = entries_[key];
+        lru_.splice(lru_.end(), lru_, e.pos);
+        append_locked(add_record(key, e));
+        return true;
+    }
+
+    // Mark a hit. Returns false if the key is not indexed; fills 'hit' when given.
+    bool on_get(const std::string& key, Hit* hit = nullptr, std::int64_t now = std::time(nullptr)) {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return false;
+        if (hit) {
+            hit->origin = it->second.origin;
+            hit->written = it->second.written;
+        }
+        lru_.splice(lru_.begin(), lru_, it->second.pos);
+        if (now - it->second.persisted_atime >= kTouchGranularity) {
+            it->second.persisted_atime = now;
+            append_locked("T\t" + key + "\t" + std::to_string(now));
+        }
+        it->second.atime = now;
+        return true;
+    }
+
+    void on_remove(const std::string& key) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (erase_locked(key)) append_locked("D\t" + key);
+    }
+
+    bool contains(const std::string& key) const {
+        std::lock_guard<std::mutex> lk(m_);
+        return entries_.count(key) != 0;
+    }
+
+    std::uint64_t total_bytes() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return total_;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return entries_.size();
+    }
+
+    std::vector<std::string> keys() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return std::vector<std::string>(lru_.begin(), lru_.end());
+    }
+
+    // Least recently used entries whose removal brings the total down to 'target' bytes.
+    // Entries are dropped from the index immediately; the caller deletes the files.
+    std::vector<Victim> take_victims(std::uint64_t target) {
+        std::lock_guard<std::mutex> lk(m_);
+        std::vector<Victim> out;
+        while (total_ > target && !lru_.empty()) {
+            const std::string key = lru_.back();
+            auto it = entries_.find(key);
+            out.push_back(Victim{key, it->second.size});
+            erase_locked(key);
+            append_locked("D\t" + key);
+        }
+        return out;
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lk(m_);
+        if (file_) std::fflush(file_);
+    }
+
+private:
+    struct Entry {
+        std::string origin;
+        std::uint64_t size = 0;
+        std::int64_t atime = 0;
+        std::int64_t persisted_atime = 0;
+        std::int64_t written = 0;
+        std::list<std::string>::iterator pos;
+    };
+
+    void close_locked() {
+        if (file_) {
+            std::fflush(file_);
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    static std::string add_record(const std::string& key, const Entry& e) {
+        std::string line = "A\t" + key + "\t" + std::to_string(e.size) + "\t" + std::to_string(e.atime);
+        line += '\t';
+        for (char c : e.origin) {
+            switch (c) {
+                case '\t': line += "\\t"; break;
+                case '\n': line += "\\n"; break;
+                case '\r': line += "\\r"; break;
+                case '\\': line += "\\\\"; break;
+                default:   line.push_back(c); break;
+            }
+        }
+        line += '\t';
+        line += std::to_string(e.written);
+        return line;
+    }
+
+    static std::string unescape(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '\\' && i + 1 < s.size()) {
+                char c = s[++i];
+                out.push_back(c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c);
+            } else {
+                out.push_back(s[i]);
+            }
+        }
+        return out;
+    }
+
+    void set_locked(const std::string& key, std::uint64_t size, std::int64_t atime, const std::string& origin,
+                    std::int64_t written) {
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            total_ -= it->second.size;
+            lru_.splice(lru_.begin(), lru_, it->second.pos);
+        } else {
+            lru_.push_front(key);
+            it = entries_.emplace(key, Entry{}).first;
+            it->second.pos = lru_.begin();
+        }
+        it->second.origin = origin;
+        it->second.written = written;
+        it->second.size = size;
+        it->second.atime = atime;
+        it->second.persisted_atime = atime;
+        total_ += size;
+    }
+
+    bool erase_locked(const std::string& key) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return false;
+        total_ -= it->second.size;
+        lru_.erase(it->second.pos);
+        entries_.erase(it);
+        return true;
+    }
+
+    void append_locked(const std::string& line) {
+        if (!file_) return;
+        std::fwrite(line.data(), 1, line.size(), file_);
+        std::fputc('\n', file_);
+        std::fflush(file_);
+        if (++records_ > kIndexCompactMin && records_ > entries_.size() * 4) {
+            close_locked();
+            rewrite_locked();
+            file_ = std::fopen(path_.c_str(), "ab");
+        }
+    }
+
+    static std::int64_t to_i64(const std::string& s) {
+        std::int64_t v = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') break;
+            v = v * 10 + (c - '0');
+        }
+        return v;
+    }
+
+    void replay_locked() {
+        std::ifstream in(path_, std::ios::in | std::ios::binary);
+        if (!in.is_open()) return;
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        // Replay in file order: later records are more recent, so each moves its key to the front
+        std::size_t pos = 0;
+        while (pos < data.size()) {
+            std::size_t nl = data.find('\n', pos);
+            if (nl == std::string::npos) break; // torn tail
+            std::string line = data.substr(pos, nl - pos);
+            pos = nl + 1;
+            std::vector<std::string> f;
+            std::size_t b = 0;
+            for (;;) {
+                std::size_t t = line.find('\t', b);
+                f.push_back(line.substr(b, t == std::string::npos ? std::string::npos : t - b));
+                if (t == std::string::npos) break;
+                b = t + 1;
+            }
+            if (f.size() < 2 || f[1].empty()) continue;
+            if (f[0] == "A" && f.size() >= 4) {
+                // Records from before write times were logged: the add time is the best guess
+                set_locked(f[1], (std::uint64_t)to_i64(f[2]), to_i64(f[3]), f.size() >= 5 ? unescape(f[4]) : std::string(),
+                           f.size() >= 6 ? to_i64(f[5]) : to_i64(f[3]));
+            } else if (f[0] == "T" && f.size() >= 3) {
+                auto it = entries_.find(f[1]);
+                if (it != entries_.end()) {
+                    it->second.atime = it->second.persisted_atime = to_i64(f[2]);
+                    lru_.splice(lru_.begin(), lru_, it->second.pos);
+                }
+            } else if (f[0] == "D") {
+                erase_locked(f[1]);
+            }
+        }
+    }
+
+    // Write one A record per live entry, oldest first, to a temp file and swap it in.
+    void rewrite_locked() {
+        const std::string tmp = path_ + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return;
+        for (auto it = lru_.rbegin(); it != lru_.rend(); ++it) {
+            std::string line = add_record(*it, entries_[*it]) + "\n";
+            std::fwrite(line.data(), 1, line.size(), f);
+        }
+        std::fclose(f);
+        std::error_code ec;
+        std::filesystem::rename(std::filesystem::path(std::u8string(tmp.begin(), tmp.end())),
+                                std::filesystem::path(std::u8string(path_.begin(), path_.end())), ec);
+        records_ = entries_.size();
+    }
+
+    mutable std::mutex m_;
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    std::size_t records_ = 0;
+    std::uint64_t total_ = 0;
+    std::list<std::string> lru_; // front = most recently used
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace cache
+} // namespace app
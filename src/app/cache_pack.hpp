@@ -0,0 +1,711 @@
+#pragma once
+// Log-structured pack backend for app::cache (header-only).
+// Values are appended to large segment files (seg-NNNNNN.pack) instead of one file per
+// key, and located through an open-addressing hash table kept in a memory-mapped file
+// (pack.idx). Reads return a zero-copy view into a read-only mapping of the segment.
+//
+// Segment record:  [u32 magic][u32 key_len][u64 value_len][u64 key_hash] key value
+//                  value_len == kTombstoneLen marks a delete (needed for crash rebuild).
+// Index file:      64-byte header followed by 'capacity' 32-byte slots.
+// The index header carries a clean-shutdown flag; if it is missing or the file is
+// damaged the index is rebuilt by scanning the segments (torn tails are truncated).
+// Segments whose dead bytes exceed kCompactDeadRatio are compacted by copying their
+// live records into a new segment; views handed out earlier stay valid because they
+// hold a reference to the mapping they point into.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <filesystem>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace app {
+namespace cache {
+namespace pack {
+
+inline constexpr std::uint32_t kRecordMagic = 0x52353946u; // "F95R"
+inline constexpr std::uint32_t kIndexMagic = 0x49353946u;  // "F95I"
+inline constexpr std::uint32_t kIndexVersion = 1;
+inline constexpr std::uint64_t kTombstoneLen = ~0ull;
+inline constexpr std::uint64_t kSegmentMaxBytes = 256ull * 1024 * 1024;
+inline constexpr std::uint64_t kInitialSlots = 4096;
+inline constexpr double kMaxLoad = 0.7;
+inline constexpr double kCompactDeadRatio = 0.5;
+
+namespace detail {
+namespace sfs = std::filesystem;
+
+inline sfs::path u8path(const std::string& s) {
+    return sfs::path(std::u8string(s.begin(), s.end()));
+}
+
+// 64-bit FNV-1a with a murmur-style finalizer; 0 and 1 are reserved for empty/deleted slots
+inline std::uint64_t key_hash(const std::string& key) {
+    std::uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h < 2 ? h + 2 : h;
+}
+
+#pragma pack(push, 1)
+struct RecordHeader {
+    std::uint32_t magic;
+    std::uint32_t key_len;
+    std::uint64_t value_len;
+    std::uint64_t key_hash;
+};
+
+struct IndexHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t capacity;
+    std::uint64_t count;
+    std::uint64_t tombstones;
+    std::uint32_t clean;
+    std::uint8_t reserved[28];
+};
+
+struct Slot {
+    std::uint64_t hash;    // 0 = empty, 1 = deleted
+    std::uint32_t segment;
+    std::uint32_t reserved;
+    std::uint64_t offset;  // record start within the segment
+    std::uint64_t length;  // value length
+};
+#pragma pack(pop)
+static_assert(sizeof(IndexHeader) == 64, "index header layout");
+static_assert(sizeof(Slot) == 32, "slot layout");
+
+// A file mapped into memory (read-only or read-write, whole file).
+class Mapping {
+public:
+    ~Mapping() { unmap(); }
+
+    bool map(const sfs::path& p, bool writable, std::uint64_t size_if_writable = 0) {
+        unmap();
+#if defined(_WIN32)
+        file_ = CreateFileW(p.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) { file_ = nullptr; return false; }
+        LARGE_INTEGER sz{};
+        if (writable) sz.QuadPart = (LONGLONG)size_if_writable;
+        else if (!GetFileSizeEx(file_, &sz)) { unmap(); return false; }
+        if (sz.QuadPart == 0) { size_ = 0; return true; }
+        map_ = CreateFileMappingW(file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                  (DWORD)(sz.QuadPart >> 32), (DWORD)(sz.QuadPart & 0xffffffff), nullptr);
+        if (!map_) { unmap(); return false; }
+        data_ = (std::uint8_t*)MapViewOfFile(map_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (!data_) { unmap(); return false; }
+        size_ = (std::uint64_t)sz.QuadPart;
+        return true;
+#else
+        fd_ = ::open(p.c_str(), writable ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);
+        if (fd_ < 0) return false;
+        std::uint64_t sz = size_if_writable;
+        if (writable) {
+            if (::ftruncate(fd_, (off_t)sz) != 0) { unmap(); return false; }
+        } else {
+            struct stat st{};
+            if (::fstat(fd_, &st) != 0) { unmap(); return false; }
+            sz = (std::uint64_t)st.st_size;
+        }
+        if (sz == 0) { size_ = 0; return true; }
+        void* p2 = ::mmap(nullptr, (size_t)sz, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd_, 0);
+        if (p2 == MAP_FAILED) { unmap(); return false; }
+        data_ = (std::uint8_t*)p2;
+        size_ = sz;
+        return true;
+#endif
+    }
+
+    void flush() {
+        if (!data_) return;
+#if defined(_WIN32)
+        FlushViewOfFile(data_, 0);
+#else
+        ::msync(data_, (size_t)size_, MS_ASYNC);
+#endif
+    }
+
+    void unmap() {
+#if defined(_WIN32)
+        if (data_) UnmapViewOfFile(data_);
+        if (map_) CloseHandle(map_);
+        if (file_) CloseHandle(file_);
+        map_ = nullptr;
+        file_ = nullptr;
+#else
+        if (data_) ::munmap(data_, (size_t)size_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    std::uint8_t* data() const { return data_; }
+    std::uint64_t size() const { return size_; }
+
+private:
+#if defined(_WIN32)
+    HANDLE file_ = nullptr;
+    HANDLE map_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::uint8_t* data_ = nullptr;
+    std::uint64_t size_ = 0;
+};
+
+inline std::FILE* open_append(const sfs::path& p) {
+#if defined(_WIN32)
+    return _wfopen(p.c_str(), L"ab");
+#else
+    return std::fopen(p.c_str(), "ab");
+#endif
+}
+
+inline std::uint64_t record_size(std::uint32_t key_len, std::uint64_t value_len) {
+    return sizeof(RecordHeader) + key_len + (value_len == kTombstoneLen ? 0 : value_len);
+}
+} // namespace detail
+
+// Read-only view of a stored value. Valid for as long as the View is alive.
+struct View {
+    std::span<const std::uint8_t> data;
+    std::shared_ptr<const detail::Mapping> hold;
+
+    explicit operator bool() const { return hold != nullptr; }
+};
+
+class Store {
+public:
+    explicit Store(std::uint64_t segment_max = kSegmentMaxBytes) : segment_max_(segment_max) {}
+    ~Store() { close(); }
+
+    // Open (or create) a pack store in 'dir'.
+    bool open(const std::string& dir) {
+        std::lock_guard<std::mutex> lk(m_);
+        close_locked();
+        ++opened_;
+        dir_ = detail::u8path(dir);
+        std::error_code ec;
+        detail::sfs::create_directories(dir_, ec);
+        if (!detail::sfs::is_directory(dir_, ec)) return false;
+
+        segments_.clear();
+        for (detail::sfs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+            auto name = it->path().filename().string();
+            std::uint32_t n = 0;
+            if (std::sscanf(name.c_str(), "seg-%6u.pack", &n) == 1) segments_[n] = Segment{};
+        }
+
+        if (!load_index_locked()) rebuild_index_locked();
+        recount_live_locked();
+        if (segments_.empty()) segments_[1] = Segment{};
+        active_ = segments_.rbegin()->first;
+        writer_ = detail::open_append(seg_path(active_));
+        if (!writer_) return false;
+        active_size_ = file_size(seg_path(active_));
+        header()->clean = 0;
+        index_.flush();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(m_);
+        close_locked();
+    }
+
+    bool is_open() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return writer_ != nullptr;
+    }
+
+    bool put(const std::string& key, std::span<const std::uint8_t> value) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!writer_) return false;
+        const std::uint64_t h = detail::key_hash(key);
+        std::uint64_t off = 0;
+        if (!append_locked(key, h, value.data(), value.size(), off)) return false;
+        insert_locked(key, h, active_, off, value.size());
+        return true;
+    }
+
+    View get(const std::string& key) {
+        std::lock_guard<std::mutex> lk(m_);
+        const detail::Slot* s = find_locked(key, detail::key_hash(key));
+        if (!s) return {};
+        auto mapping = mapping_for_locked(s->segment, s->offset + detail::record_size((std::uint32_t)key.size(), s->length));
+        if (!mapping) return {};
+        const std::uint8_t* p = mapping->data() + s->offset + sizeof(detail::RecordHeader) + key.size();
+        return View{std::span<const std::uint8_t>(p, (std::size_t)s->length), mapping};
+    }
+
+    bool contains(const std::string& key) {
+        std::lock_guard<std::mutex> lk(m_);
+        return find_locked(key, detail::key_hash(key)) != nullptr;
+    }
+
+    bool remove(const std::string& key) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!writer_) return false;
+        const std::uint64_t h = detail::key_hash(key);
+        detail::Slot* s = find_locked(key, h);
+        if (!s) return false;
+        std::uint64_t off = 0;
+        if (!append_locked(key, h, nullptr, kTombstoneLen, off)) return false;
+        // The tombstone itself is dead weight as soon as it is written
+        segments_[active_].dead += detail::record_size((std::uint32_t)key.size(), kTombstoneLen);
+        kill_slot_locked(*s, (std::uint32_t)key.size());
+        return true;
+    }
+
+    std::uint64_t live_bytes() const {
+        std::lock_guard<std::mutex> lk(m_);
+        std::uint64_t n = 0;
+        for (const auto& kv : segments_) n += kv.second.live;
+        return n;
+    }
+
+    // Bytes on disk, dead records included
+    std::uint64_t disk_bytes() const {
+        std::lock_guard<std::mutex> lk(m_);
+        std::uint64_t n = 0;
+        for (const auto& kv : segments_) n += kv.second.live + kv.second.dead;
+        return n;
+    }
+
+    // Drop whole segments, oldest first, until at most 'target' bytes remain on disk. Every
+    // record in a dropped segment is forgotten, so this suits stores whose values can be
+    // recreated. The active segment is sealed and dropped last. Returns bytes dropped.
+    std::uint64_t evict_oldest(std::uint64_t target) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!writer_ || compacting_) return 0;
+        std::uint64_t total = 0;
+        for (const auto& kv : segments_) total += kv.second.live + kv.second.dead;
+        std::uint64_t dropped = 0;
+        while (total > target && !segments_.empty()) {
+            if (segments_.begin()->first == active_ && (active_size_ == 0 || !roll_locked())) break;
+            const auto it = segments_.begin();
+            const std::uint32_t seg = it->first;
+            const std::uint64_t bytes = it->second.live + it->second.dead;
+            detail::Slot* slots = slot_base();
+            for (std::uint64_t i = 0; i < header()->capacity; ++i) {
+                if (slots[i].hash < 2 || slots[i].segment != seg) continue;
+                slots[i].hash = 1;
+                header()->count--;
+                header()->tombstones++;
+            }
+            segments_.erase(it);
+            maps_.erase(seg);
+            std::error_code ec;
+            detail::sfs::remove(seg_path(seg), ec); // Windows: fails while a View still maps it; compacted later
+            total -= (std::min)(total, bytes);
+            dropped += bytes;
+        }
+        index_.flush();
+        return dropped;
+    }
+
+    std::uint64_t count() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return index_.data() ? ((const detail::IndexHeader*)index_.data())->count : 0;
+    }
+
+    // Rewrite sealed segments that are mostly dead. Returns bytes reclaimed.
+    // The lock is only held to pick the live records and, afterwards, to repoint the index
+    // and drop the old segments; the copy itself runs unlocked, so lookups and writes
+    // continue meanwhile. The copy gets a segment number below the new active segment, so
+    // records written during the copy still replay after it on a rebuild.
+    std::uint64_t compact() {
+        struct Copy {
+            std::string key;
+            std::uint64_t hash = 0;
+            std::uint32_t segment = 0;
+            std::uint64_t offset = 0; // in the old segment
+            std::uint64_t length = 0; // value length or kTombstoneLen
+            std::size_t map = 0;      // index into 'maps'
+            std::uint64_t to = 0;     // offset in the new segment
+        };
+        std::vector<std::uint32_t> victims;
+        std::vector<std::shared_ptr<const detail::Mapping>> maps;
+        std::vector<Copy> copies;
+        std::uint32_t out = 0;
+        std::uint64_t opened = 0;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!writer_ || compacting_) return 0;
+            // A mostly dead active segment is sealed first so it can be compacted too
+            {
+                const Segment& a = segments_[active_];
+                if (active_size_ > 0 && (double)a.dead / (double)(a.live + a.dead) >= kCompactDeadRatio && !roll_locked()) {
+                    return 0;
+                }
+            }
+            for (const auto& kv : segments_) {
+                if (kv.first == active_) continue;
+                const std::uint64_t total = kv.second.live + kv.second.dead;
+                if (total != 0 && (double)kv.second.dead / (double)total < kCompactDeadRatio) continue;
+                auto mapping = mapping_for_locked(kv.first, file_size(seg_path(kv.first)));
+                if (!mapping && file_size(seg_path(kv.first)) != 0) continue;
+                victims.push_back(kv.first);
+                if (!mapping) continue;
+                // Tombstones must survive while an older segment could still hold the key they delete
+                const bool has_older = segments_.begin()->first < kv.first;
+                std::uint64_t pos = 0;
+                while (pos + sizeof(detail::RecordHeader) <= mapping->size()) {
+                    const auto* rh = (const detail::RecordHeader*)(mapping->data() + pos);
+                    const std::uint64_t rs = detail::record_size(rh->key_len, rh->value_len);
+                    if (rh->magic != kRecordMagic || pos + rs > mapping->size()) break;
+                    std::string key((const char*)(rh + 1), rh->key_len);
+                    bool keep = false;
+                    if (rh->value_len == kTombstoneLen) {
+                        keep = has_older && !find_locked(key, rh->key_hash);
+                    } else if (const detail::Slot* s = find_locked(key, rh->key_hash)) {
+                        keep = s->segment == kv.first && s->offset == pos;
+                    }
+                    if (keep) copies.push_back(Copy{std::move(key), rh->key_hash, kv.first, pos, rh->value_len, maps.size(), 0});
+                    pos += rs;
+                }
+                maps.push_back(std::move(mapping));
+            }
+            if (victims.empty()) return 0;
+            if (!copies.empty()) {
+                out = active_ + 1;
+                segments_[out] = Segment{};
+                if (!roll_locked(out + 1)) {
+                    segments_.erase(out);
+                    return 0;
+                }
+                compacting_ = true;
+                opened = opened_;
+            }
+        }
+
+        // Copy without the lock: victims are sealed, and the mappings stay valid while held
+        bool ok = true;
+        if (!copies.empty()) {
+            std::FILE* f = detail::open_append(seg_path(out));
+            ok = f != nullptr;
+            std::uint64_t size = 0;
+            for (auto& c : copies) {
+                if (!ok) break;
+                const auto* rh = (const detail::RecordHeader*)(maps[c.map]->data() + c.offset);
+                const std::uint64_t rs = detail::record_size(rh->key_len, rh->value_len);
+                ok = std::fwrite(rh, 1, (std::size_t)rs, f) == rs;
+                c.to = size;
+                size += rs;
+            }
+            if (f) ok = std::fclose(f) == 0 && ok;
+        }
+
+        std::lock_guard<std::mutex> lk(m_);
+        compacting_ = false;
+        if (!copies.empty() && (!ok || !writer_ || opened != opened_)) {
+            // Nothing points into the copy yet; dropping it leaves the store as it was
+            segments_.erase(out);
+            std::error_code ec;
+            detail::sfs::remove(seg_path(out), ec);
+            return 0;
+        }
+        for (const auto& c : copies) {
+            const std::uint64_t rs = detail::record_size((std::uint32_t)c.key.size(), c.length);
+            detail::Slot* s = c.length == kTombstoneLen ? nullptr : find_locked(c.key, c.hash);
+            if (s && s->segment == c.segment && s->offset == c.offset) {
+                s->segment = out;
+                s->offset = c.to;
+                segments_[out].live += rs;
+            } else {
+                // A tombstone, or a record overwritten or deleted while it was being copied
+                segments_[out].dead += rs;
+            }
+        }
+        std::uint64_t reclaimed = 0;
+        for (std::uint32_t seg : victims) {
+            auto it = segments_.find(seg);
+            if (it == segments_.end()) continue;
+            reclaimed += it->second.dead;
+            segments_.erase(it);
+            maps_.erase(seg);
+            std::error_code ec;
+            detail::sfs::remove(seg_path(seg), ec); // Windows: fails while a View still maps it; retried next time
+        }
+        index_.flush();
+        return reclaimed;
+    }
+
+private:
+    struct Segment {
+        std::uint64_t live = 0;
+        std::uint64_t dead = 0;
+    };
+
+    detail::sfs::path seg_path(std::uint32_t n) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "seg-%06u.pack", n);
+        return dir_ / name;
+    }
+
+    static std::uint64_t file_size(const detail::sfs::path& p) {
+        std::error_code ec;
+        auto n = detail::sfs::file_size(p, ec);
+        return ec ? 0 : (std::uint64_t)n;
+    }
+
+    detail::IndexHeader* header() { return (detail::IndexHeader*)index_.data(); }
+    detail::Slot* slot_base() { return (detail::Slot*)(index_.data() + sizeof(detail::IndexHeader)); }
+
+    void close_locked() {
+        if (writer_) {
+            std::fflush(writer_);
+            std::fclose(writer_);
+            writer_ = nullptr;
+        }
+        if (index_.data()) {
+            header()->clean = 1;
+            index_.flush();
+        }
+        index_.unmap();
+        maps_.clear();
+    }
+
+    bool create_index_locked(std::uint64_t capacity) {
+        const std::uint64_t bytes = sizeof(detail::IndexHeader) + capacity * sizeof(detail::Slot);
+        const auto p = dir_ / "pack.idx";
+        // A mapping can grow a file but never shrink it on Windows: cut it first
+        index_.unmap();
+        if (file_size(p) > bytes) {
+            std::error_code ec;
+            detail::sfs::resize_file(p, bytes, ec);
+        }
+        if (!index_.map(p, true, bytes)) return false;
+        std::memset(index_.data(), 0, (std::size_t)bytes);
+        detail::IndexHeader* h = header();
+        h->magic = kIndexMagic;
+        h->version = kIndexVersion;
+        h->capacity = capacity;
+        return true;
+    }
+
+    bool load_index_locked() {
+        const auto p = dir_ / "pack.idx";
+        const std::uint64_t size = file_size(p);
+        if (size < sizeof(detail::IndexHeader)) return false;
+        if (!index_.map(p, true, size)) return false;
+        const detail::IndexHeader* h = header();
+        const std::uint64_t max_slots = (size - sizeof(detail::IndexHeader)) / sizeof(detail::Slot);
+        if (h->magic != kIndexMagic || h->version != kIndexVersion || h->clean != 1 ||
+            h->capacity == 0 || h->capacity > max_slots) {
+            index_.unmap();
+            return false;
+        }
+        // Longer than the table (left behind by a shrink that could not truncate): drop the tail
+        const std::uint64_t bytes = sizeof(detail::IndexHeader) + h->capacity * sizeof(detail::Slot);
+        if (size > bytes) {
+            index_.unmap();
+            std::error_code ec;
+            detail::sfs::resize_file(p, bytes, ec);
+            if (!index_.map(p, true, bytes)) return false;
+        }
+        return true;
+    }
+
+    // Scan every segment in order and replay puts/deletes; truncates torn tails.
+    void rebuild_index_locked() {
+        create_index_locked(kInitialSlots);
+        for (auto& kv : segments_) {
+            const auto path = seg_path(kv.first);
+            detail::Mapping m;
+            if (!m.map(path, false)) continue;
+            std::uint64_t pos = 0;
+            while (pos + sizeof(detail::RecordHeader) <= m.size()) {
+                const auto* rh = (const detail::RecordHeader*)(m.data() + pos);
+                if (rh->magic != kRecordMagic) break;
+                const std::uint64_t rs = detail::record_size(rh->key_len, rh->value_len);
+                if (pos + rs > m.size()) break;
+                std::string key((const char*)(rh + 1), rh->key_len);
+                if (rh->value_len == kTombstoneLen) {
+                    if (detail::Slot* s = find_locked(key, rh->key_hash)) kill_slot_locked(*s, rh->key_len);
+                } else {
+                    insert_locked(key, rh->key_hash, kv.first, pos, rh->value_len);
+                }
+                pos += rs;
+            }
+            const std::uint64_t valid = pos;
+            const std::uint64_t actual = m.size();
+            m.unmap();
+            if (valid < actual) {
+                std::error_code ec;
+                detail::sfs::resize_file(path, valid, ec);
+            }
+        }
+    }
+
+    // Derive live byte counts per segment from the index; everything else in a segment is dead.
+    void recount_live_locked() {
+        for (auto& kv : segments_) kv.second = Segment{};
+        const detail::IndexHeader* h = header();
+        const detail::Slot* slots = slot_base();
+        for (std::uint64_t i = 0; i < h->capacity; ++i) {
+            const detail::Slot& s = slots[i];
+            if (s.hash < 2) continue;
+            auto it = segments_.find(s.segment);
+            if (it == segments_.end()) continue;
+            auto mapping = mapping_for_locked(s.segment, 0);
+            if (!mapping || s.offset + sizeof(detail::RecordHeader) > mapping->size()) continue;
+            const auto* rh = (const detail::RecordHeader*)(mapping->data() + s.offset);
+            it->second.live += detail::record_size(rh->key_len, s.length);
+        }
+        for (auto& kv : segments_) {
+            const std::uint64_t total = file_size(seg_path(kv.first));
+            kv.second.dead = total > kv.second.live ? total - kv.second.live : 0;
+        }
+    }
+
+    // Mapping of segment 'seg' that covers at least 'need' bytes (remapped if the file grew).
+    // need == 0 accepts any existing mapping.
+    std::shared_ptr<const detail::Mapping> mapping_for_locked(std::uint32_t seg, std::uint64_t need) {
+        auto it = maps_.find(seg);
+        if (it != maps_.end() && it->second->size() >= need) return it->second;
+        if (writer_ && seg == active_) std::fflush(writer_);
+        auto m = std::make_shared<detail::Mapping>();
+        if (!m->map(seg_path(seg), false) || m->size() < need) return nullptr;
+        maps_[seg] = m;
+        return m;
+    }
+
+    // Seal the active segment and start appending to a new one ('next', default the following number).
+    bool roll_locked(std::uint32_t next = 0) {
+        std::fclose(writer_);
+        active_ = next ? next : active_ + 1;
+        segments_[active_] = Segment{};
+        writer_ = detail::open_append(seg_path(active_));
+        active_size_ = 0;
+        return writer_ != nullptr;
+    }
+
+    bool append_locked(const std::string& key, std::uint64_t h, const std::uint8_t* value, std::uint64_t len,
+                       std::uint64_t& offset) {
+        const std::uint64_t rs = detail::record_size((std::uint32_t)key.size(), len);
+        if (active_size_ > 0 && active_size_ + rs > segment_max_ && !roll_locked()) return false;
+        detail::RecordHeader rh{kRecordMagic, (std::uint32_t)key.size(), len, h};
+        offset = active_size_;
+        bool ok = std::fwrite(&rh, sizeof(rh), 1, writer_) == 1 &&
+                  std::fwrite(key.data(), 1, key.size(), writer_) == key.size();
+        if (ok && len != kTombstoneLen && len > 0) ok = std::fwrite(value, 1, (std::size_t)len, writer_) == len;
+        if (!ok) {
+            // Leave the file at the last good record so offsets stay consistent
+            std::fclose(writer_);
+            std::error_code ec;
+            detail::sfs::resize_file(seg_path(active_), active_size_, ec);
+            writer_ = detail::open_append(seg_path(active_));
+            return false;
+        }
+        std::fflush(writer_);
+        active_size_ += rs;
+        return true;
+    }
+
+    bool key_matches_locked(const detail::Slot& s, const std::string& key) {
+        auto mapping = mapping_for_locked(s.segment, s.offset + sizeof(detail::RecordHeader) + key.size());
+        if (!mapping) return false;
+        const auto* rh = (const detail::RecordHeader*)(mapping->data() + s.offset);
+        return rh->key_len == key.size() && std::memcmp(rh + 1, key.data(), key.size()) == 0;
+    }
+
+    detail::Slot* find_locked(const std::string& key, std::uint64_t h) {
+        if (!index_.data()) return nullptr;
+        const std::uint64_t cap = header()->capacity;
+        detail::Slot* slots = slot_base();
+        for (std::uint64_t i = 0, at = h & (cap - 1); i < cap; ++i, at = (at + 1) & (cap - 1)) {
+            detail::Slot& s = slots[at];
+            if (s.hash == 0) return nullptr;
+            if (s.hash == h && key_matches_locked(s, key)) return &s;
+        }
+        return nullptr;
+    }
+
+    void kill_slot_locked(detail::Slot& s, std::uint32_t key_len) {
+        auto seg = segments_.find(s.segment);
+        if (seg != segments_.end()) {
+            const std::uint64_t rs = detail::record_size(key_len, s.length);
+            seg->second.live -= (std::min)(seg->second.live, rs);
+            seg->second.dead += rs;
+        }
+        s.hash = 1;
+        header()->count--;
+        header()->tombstones++;
+    }
+
+    void insert_locked(const std::string& key, std::uint64_t h, std::uint32_t seg, std::uint64_t off, std::uint64_t len) {
+        if (detail::Slot* old = find_locked(key, h)) kill_slot_locked(*old, (std::uint32_t)key.size());
+        if ((double)(header()->count + header()->tombstones + 1) > (double)header()->capacity * kMaxLoad) grow_locked();
+        const std::uint64_t cap = header()->capacity;
+        detail::Slot* slots = slot_base();
+        std::uint64_t at = h & (cap - 1);
+        while (slots[at].hash >= 2) at = (at + 1) & (cap - 1);
+        if (slots[at].hash == 1) header()->tombstones--;
+        slots[at] = detail::Slot{h, seg, 0, off, len};
+        header()->count++;
+        segments_[seg].live += detail::record_size((std::uint32_t)key.size(), len);
+    }
+
+    // Rehash into a table twice as large (or the same size if mostly tombstones).
+    void grow_locked() {
+        const detail::IndexHeader old_h = *header();
+        std::vector<detail::Slot> live;
+        live.reserve((std::size_t)old_h.count);
+        const detail::Slot* slots = slot_base();
+        for (std::uint64_t i = 0; i < old_h.capacity; ++i) if (slots[i].hash >= 2) live.push_back(slots[i]);
+        std::uint64_t cap = old_h.capacity;
+        while ((double)(live.size() + 1) > (double)cap * kMaxLoad / 2) cap *= 2;
+        index_.unmap();
+        create_index_locked(cap);
+        detail::Slot* ns = slot_base();
+        for (const auto& s : live) {
+            std::uint64_t at = s.hash & (cap - 1);
+            while (ns[at].hash != 0) at = (at + 1) & (cap - 1);
+            ns[at] = s;
+        }
+        header()->count = live.size();
+    }
+
+    mutable std::mutex m_;
+    detail::sfs::path dir_;
+    detail::Mapping index_;
+    std::map<std::uint32_t, Segment> segments_;
+    std::map<std::uint32_t, std::shared_ptr<const detail::Mapping>> maps_;
+    std::uint32_t active_ = 0;
+    std::uint64_t active_size_ = 0;
+    std::FILE* writer_ = nullptr;
+    std::uint64_t segment_max_ = kSegmentMaxBytes;
+    std::uint64_t opened_ = 0;   // bumped by open(); a compaction spanning a reopen is dropped
+    bool compacting_ = false;
+};
+
+} // namespace pack
+} // namespace cache
+} // namespace app
@@ -0,0 +1,424 @@
+#pragma once
+// Two-tier cache front (header-only): sharded in-memory LRU over the disk cache, with
+// single-flight loading. Concurrent misses on one key share one in-flight load; callers
+// get a shared_future that resolves to the bytes (nullptr when the load failed).
+// Lookup order: memory -> disk (app::cache) -> loader(). Successful loads populate both
+// tiers unless the Options say otherwise; on disk, values up to kPackMaxValue are packed.
+// Freshness is per namespace (Options::ns): entries within the policy's ttl are served
+// as is; stale entries are served immediately while one background reload refreshes
+// them; entries past the stale window are reloaded first, and kept if the reload fails.
+// Loads run on a small pool (kLoadWorkers); refreshes get at most kMaxRefreshRunning of
+// its workers and never more than kMaxRefreshQueued waiting, so a screen of stale hits
+// cannot crowd out misses or start a thread each.
+
+#include <string>
+#include <list>
+#include <array>
+#include <memory>
+#include <future>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <deque>
+#include <unordered_set>
+
+#include "cache.hpp"
+#include "runtime.hpp"
+
+namespace app {
+namespace cache {
+
+using Value = std::shared_ptr<const std::string>;
+using Loader = std::function<Value()>;
+
+inline constexpr std::size_t kMemoryShards = 16;
+inline constexpr std::uint64_t kDefaultMemoryBudget = 128ull * 1024 * 1024;
+inline constexpr std::size_t kPackMaxValue = 256 * 1024; // larger values get their own file
+inline constexpr int kLoadWorkers = 8;                    // concurrent loads (misses and refreshes)
+inline constexpr int kMaxRefreshRunning = 2;              // workers background refreshes may hold
+inline constexpr std::size_t kMaxRefreshQueued = 64;      // further stale hits wait for a later access
+
+struct Options {
+    bool memory = true; // keep the result in the memory tier
+    bool disk = true;   // read from / write to the disk cache
+    std::string ns;     // freshness namespace (see policy_for); empty = never expires
+};
+
+struct Policy {
+    std::int64_t ttl = 0;   // seconds an entry counts as fresh; 0 = forever
+    std::int64_t stale = 0; // further seconds it may be served while revalidating
+};
+
+inline constexpr const char* kNsCover = "cover";   // cover art and screenshots
+inline constexpr const char* kNsThread = "thread"; // thread pages (version, changelog, links)
+
+namespace detail {
+struct Policies {
+    std::mutex m;
+    std::map<std::string, Policy> by_ns{
+        {kNsCover, Policy{7 * 86400, 90 * 86400}},
+        {kNsThread, Policy{15 * 60, 30 * 86400}},
+    };
+};
+
+inline Policies& policies() {
+    static Policies p;
+    return p;
+}
+} // namespace detail
+
+inline void set_policy(const std::string& ns, Policy p) {
+    auto& ps = detail::policies();
+    std::lock_guard<std::mutex> lk(ps.m);
+    ps.by_ns[ns] = p;
+}
+
+inline Policy policy_for(const std::string& ns) {
+    if (ns.empty()) return {};
+    auto& ps = detail::policies();
+    std::lock_guard<std::mutex> lk(ps.m);
+    auto it = ps.by_ns.find(ns);
+    return it == ps.by_ns.end() ? Policy{} : it->second;
+}
+
+enum class Freshness { Fresh, Stale, Expired };
+
+// Entries with an unknown write time (written == 0) count as stale, not expired.
+inline Freshness freshness(const Policy& p, std::int64_t written, std::int64_t now = std::time(nullptr)) {
+    if (p.ttl <= 0) return Freshness::Fresh;
+    if (written <= 0) return Freshness::Stale;
+    const std::int64_t age = now - written;
+    if (age < p.ttl) return Freshness::Fresh;
+    return age < p.ttl + p.stale ? Freshness::Stale : Freshness::Expired;
+}
+
+// Byte-budgeted LRU split into shards so lookups from many threads rarely contend.
+class MemoryTier {
+public:
+    explicit MemoryTier(std::uint64_t budget = kDefaultMemoryBudget) { set_budget(budget); }
+
+    void set_budget(std::uint64_t bytes) {
+        per_shard_budget_ = bytes / kMemoryShards;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lk(s.m);
+            trim_locked(s);
+        }
+    }
+
+    // 'written' receives the entry's write time (unix seconds) when given.
+    Value get(const std::string& key, std::int64_t* written = nullptr) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return nullptr;
+        s.lru.splice(s.lru.begin(), s.lru, it->second.pos);
+        if (written) *written = it->second.written;
+        return it->second.value;
+    }
+
+    void put(const std::string& key, Value v, std::int64_t written = std::time(nullptr)) {
+        if (!v) return;
+        const std::uint64_t sz = v->size();
+        if (sz > per_shard_budget_) return; // would evict the whole shard for one entry
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it = s.map.find(key);
+        if (it != s.map.end()) {
+            s.bytes -= it->second.value->size();
+            s.lru.splice(s.lru.begin(), s.lru, it->second.pos);
+            it->second.value = std::move(v);
+            it->second.written = written;
+        } else {
+            s.lru.push_front(key);
+            s.map.emplace(key, Node{std::move(v), written, s.lru.begin()});
+        }
+        s.bytes += sz;
+        trim_locked(s);
+    }
+
+    void erase(const std::string& key) {
+        Shard& s = shard_for(key);
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return;
+        s.bytes -= it->second.value->size();
+        s.lru.erase(it->second.pos);
+        s.map.erase(it);
+    }
+
+    std::uint64_t bytes() const {
+        std::uint64_t n = 0;
+        for (auto& s : shards_) {
+            std::lock_guard<std::mutex> lk(s.m);
+            n += s.bytes;
+        }
+        return n;
+    }
+
+private:
+    struct Node {
+        Value value;
+        std::int64_t written = 0;
+        std::list<std::string>::iterator pos;
+    };
+    struct Shard {
+        mutable std::mutex m;
+        std::list<std::string> lru; // front = most recent
+        std::unordered_map<std::string, Node> map;
+        std::uint64_t bytes = 0;
+    };
+
+    Shard& shard_for(const std::string& key) {
+        return shards_[std::hash<std::string>{}(key) % kMemoryShards];
+    }
+
+    void trim_locked(Shard& s) {
+        while (s.bytes > per_shard_budget_ && !s.lru.empty()) {
+            auto it = s.map.find(s.lru.back());
+            s.bytes -= it->second.value->size();
+            s.map.erase(it);
+            s.lru.pop_back();
+        }
+    }
+
+    std::array<Shard, kMemoryShards> shards_;
+    std::atomic<std::uint64_t> per_shard_budget_{0};
+};
+
+inline MemoryTier& memory() {
+    static MemoryTier tier;
+    return tier;
+}
+
+namespace detail {
+// Worker pool for loads. Misses go first; a refresh only takes a worker when no miss is
+// waiting and fewer than kMaxRefreshRunning refreshes run. Workers are spawned on demand
+// and exit when nothing is runnable.
+class LoadPool {
+public:
+    void submit(std::function<void()> task) {
+        std::lock_guard<std::mutex> lk(m_);
+        loads_.push_back(std::move(task));
+        spawn_locked();
+    }
+
+    // False (task dropped) if kMaxRefreshQueued refreshes are already waiting
+    bool submit_refresh(std::function<void()> task) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (refreshes_.size() >= kMaxRefreshQueued) return false;
+        refreshes_.push_back(std::move(task));
+        spawn_locked();
+        return true;
+    }
+
+private:
+    void spawn_locked() {
+        if (workers_ >= kLoadWorkers) return;
+        ++workers_;
+        app::runtime::schedule([this]{ work(); });
+    }
+
+    void work() {
+        for (;;) {
+            std::function<void()> task;
+            bool refresh = false;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (!loads_.empty()) {
+                    task = std::move(loads_.front());
+                    loads_.pop_front();
+                } else if (!refreshes_.empty() && refresh_running_ < kMaxRefreshRunning) {
+                    task = std::move(refreshes_.front());
+                    refreshes_.pop_front();
+                    ++refresh_running_;
+                    refresh = true;
+                } else {
+                    --workers_;
+                    return;
+                }
+            }
+            task();
+            if (refresh) {
+                std::lock_guard<std::mutex> lk(m_);
+                --refresh_running_;
+            }
+        }
+    }
+
+    std::mutex m_;
+    std::deque<std::function<void()>> loads_;
+    std::deque<std::function<void()>> refreshes_;
+    int workers_ = 0;
+    int refresh_running_ = 0;
+};
+
+inline LoadPool& pool() {
+    static LoadPool p;
+    return p;
+}
+
+struct Inflight {
+    std::mutex m;
+    std::unordered_map<std::string, std::shared_future<Value>> loads;
+    std::unordered_set<std::string> refreshing; // keys with a background revalidation running
+};
+
+inline Inflight& inflight() {
+    static Inflight f;
+    return f;
+}
+
+inline Value read_disk(const std::string& key, std::int64_t* written) {
+    if (pack::View v = get_packed(key, written)) {
+        return std::make_shared<std::string>((const char*)v.data.data(), v.data.size());
+    }
+    std::string p = get(key, written);
+    if (p.empty()) return nullptr;
+    std::ifstream in(u8path(p), std::ios::binary);
+    if (!in.is_open()) return nullptr;
+    auto s = std::make_shared<std::string>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return s;
+}
+
+inline std::shared_future<Value> ready(Value v) {
+    std::promise<Value> p;
+    p.set_value(std::move(v));
+    return p.get_future().share();
+}
+
+inline void store(const std::string& key, const Value& v, const Options& opt) {
+    if (opt.disk) {
+        const std::span<const std::uint8_t> bytes((const std::uint8_t*)v->data(), v->size());
+        if (v->size() > kPackMaxValue || !put_packed(key, bytes)) put_bytes(key, bytes);
+    }
+    if (opt.memory) memory().put(key, v);
+}
+
+// Reload 'key' in the background, at most once at a time per key. Old data stays in
+// place until the reload succeeds; with the refresh queue full it is retried on a later hit.
+inline void revalidate(const std::string& key, const Loader& loader, const Options& opt) {
+    if (!loader) return;
+    auto& f = inflight();
+    {
+        std::lock_guard<std::mutex> lk(f.m);
+        if (!f.refreshing.insert(key).second) return;
+    }
+    const bool queued = pool().submit_refresh([key, loader, opt]{
+        Value v;
+        try {
+            v = loader();
+        } catch (...) {
+            v = nullptr;
+        }
+        if (v) store(key, v, opt);
+        auto& fl = inflight();
+        std::lock_guard<std::mutex> lk(fl.m);
+        fl.refreshing.erase(key);
+    });
+    if (!queued) {
+        std::lock_guard<std::mutex> lk(f.m);
+        f.refreshing.erase(key);
+    }
+}
+
+// 'fallback' is an expired copy to return if nothing better can be loaded.
+inline Value resolve(const std::string& key, const Loader& loader, const Options& opt, Value fallback) {
+    std::int64_t written = 0;
+    Value v = opt.disk ? read_disk(key, &written) : nullptr;
+    if (v) {
+        const Freshness f = freshness(policy_for(opt.ns), written);
+        if (f != Freshness::Expired) {
+            // Populate memory before revalidating so the refresh cannot be overwritten
+            if (opt.memory) memory().put(key, v, written);
+            if (f == Freshness::Stale) revalidate(key, loader, opt);
+            return v;
+        }
+        fallback = std::move(v);
+    }
+    if (loader) v = loader();
+    if (v) store(key, v, opt);
+    return v ? v : fallback;
+}
+
+// Memory tier lookup: a fresh or stale hit is returned (stale ones are refreshed in the
+// background); an expired one goes to 'expired' as the fallback for the load.
+inline Value memory_hit(const std::string& key, const Loader& loader, const Options& opt, Value& expired) {
+    if (!opt.memory) return nullptr;
+    std::int64_t written = 0;
+    Value v = memory().get(key, &written);
+    if (!v) return nullptr;
+    switch (freshness(policy_for(opt.ns), written)) {
+        case Freshness::Fresh: return v;
+        case Freshness::Stale:
+            revalidate(key, loader, opt);
+            return v;
+        case Freshness::Expired: expired = std::move(v); break;
+    }
+    return nullptr;
+}
+
+// Run the load for 'key' on the calling thread and hand the result to every waiter.
+inline Value run_load(const std::string& key, const Loader& loader, const Options& opt, const Value& expired,
+                      std::promise<Value>& promise) {
+    Value v;
+    try {
+        v = resolve(key, loader, opt, expired);
+    } catch (...) {
+        v = expired;
+    }
+    {
+        auto& f = inflight();
+        std::lock_guard<std::mutex> lk(f.m);
+        f.loads.erase(key);
+    }
+    promise.set_value(v);
+    return v;
+}
+} // namespace detail
+
+// Asynchronous lookup. A fresh or stale memory hit returns an already-ready future;
+// otherwise the disk read and loader run on a pool worker, shared by every concurrent
+// caller of 'key'.
+inline std::shared_future<Value> get_or_load(const std::string& key, Loader loader, Options opt = {}) {
+    Value expired;
+    if (Value v = detail::memory_hit(key, loader, opt, expired)) return detail::ready(std::move(v));
+    auto& f = detail::inflight();
+    std::lock_guard<std::mutex> lk(f.m);
+    auto it = f.loads.find(key);
+    if (it != f.loads.end()) return it->second;
+
+    auto promise = std::make_shared<std::promise<Value>>();
+    std::shared_future<Value> fut = promise->get_future().share();
+    f.loads.emplace(key, fut);
+    detail::pool().submit([key, loader = std::move(loader), opt, promise, expired]{
+        detail::run_load(key, loader, opt, expired, *promise);
+    });
+    return fut;
+}
+
+// Blocking variant for callers already on a worker thread. The load runs on the calling
+// thread rather than a pool worker, so the caller never holds one thread waiting on
+// another; it only waits when someone else is already loading 'key'.
+inline Value get_or_load_sync(const std::string& key, const Loader& loader, Options opt = {}) {
+    Value expired;
+    if (Value v = detail::memory_hit(key, loader, opt, expired)) return v;
+    std::promise<Value> promise;
+    std::shared_future<Value> other;
+    {
+        auto& f = detail::inflight();
+        std::lock_guard<std::mutex> lk(f.m);
+        auto it = f.loads.find(key);
+        if (it != f.loads.end()) other = it->second;
+        else f.loads.emplace(key, promise.get_future().share());
+    }
+    if (other.valid()) return other.get();
+    return detail::run_load(key, loader, opt, expired, promise);
+}
+
+} // namespace cache
+} // namespace app
@@ -13,6 +13,7 @@
 #include <vector>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 
 namespace app {
 namespace config {
@@ -29,6 +30,8 @@ struct AppConfig {
     // Behavior
     bool cache_on_download = true; // settings-cache-on-download
     bool log_to_file = false;      // settings-log-to-file
+    std::uint64_t cache_max_mb = 2048; // settings-cache-max-mb (0 = unlimited)
+    std::uint64_t cover_atlas_mb = 64; // settings-cover-atlas-mb (GPU memory for card covers)
 
     // Launch
     std::string custom_launch;     // settings-custom-launch ({{path}} placeholder)
@@ -82,6 +85,8 @@ inline AppConfig merge(const AppConfig& a, const AppConfig& b) {
     // bools (explicit overrides)
     out.cache_on_download = b.cache_on_download;
     out.log_to_file       = b.log_to_file;
+    out.cache_max_mb      = b.cache_max_mb;
+    out.cover_atlas_mb    = b.cover_atlas_mb;
 
     // vectors (replace if provided)
     if (!b.startup_tags.empty())               out.startup_tags = b.startup_tags;
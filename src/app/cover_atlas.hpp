@@ -0,0 +1,271 @@
+#pragma once
+// Cover texture atlas (header-only, renderer-agnostic).
+// Card thumbnails are packed into a few large square pages instead of one texture each,
+// so a grid of cards draws from one or two textures. Pages are carved into shelves
+// (rows of equal-height slots); freed slots become holes that later thumbnails reuse.
+// Residency is kept under a byte budget: when no slot is free and no page may be added,
+// the least recently drawn thumbnails not drawn in this or the previous frame are evicted
+// (uploads happen at the start of a frame, before this frame's cards are drawn).
+// Page creation/upload/destruction go through PageOps, so the allocator and eviction
+// run without a GPU (tests, benchmarks) with no-op or recording ops.
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+namespace app {
+namespace covers {
+
+using Texture = std::uintptr_t; // renderer handle; 0 = none
+
+// Borrowed RGBA8 pixels: width * height * 4 bytes, rows top to bottom, no padding
+struct Pixels {
+    int width = 0;
+    int height = 0;
+    const std::uint8_t* rgba = nullptr;
+};
+
+struct PageOps {
+    std::function<Texture(int size)> create;                                   // empty size x size RGBA8 page
+    std::function<void(Texture page, int x, int y, const Pixels& px)> update; // write a sub-rectangle
+    std::function<void(Texture page)> destroy;
+};
+
+// Where a thumbnail lives: page texture plus normalized UVs. page == 0 means not resident.
+struct Sprite {
+    Texture page = 0;
+    float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+
+    explicit operator bool() const { return page != 0; }
+};
+
+inline constexpr int kAtlasPageSize = 2048;
+inline constexpr std::uint64_t kDefaultAtlasBudget = 64ull * 1024 * 1024;
+
+class Atlas {
+public:
+    explicit Atlas(int page_size = kAtlasPageSize, std::uint64_t budget = kDefaultAtlasBudget)
+        : page_size_(page_size) { set_budget(budget); }
+    ~Atlas() { clear(); }
+
+    void set_ops(PageOps ops) { ops_ = std::move(ops); }
+
+    // Called with the key of every thumbnail evicted to make room (not for erase() or
+    // clear()), so the owner can forget it was loaded and request it again.
+    void set_on_evict(std::function<void(const std::string& key)> f) { on_evict_ = std::move(f); }
+
+    // At least one page is always allowed; pages above the new limit go once they empty.
+    void set_budget(std::uint64_t bytes) {
+        const std::uint64_t page_bytes = (std::uint64_t)page_size_ * page_size_ * 4;
+        max_pages_ = (std::max)(std::uint64_t(1), bytes / page_bytes);
+    }
+
+    // Call once per frame before uploading and drawing.
+    void begin_frame() { ++frame_; }
+
+    // Look up 'key' and mark it drawn this frame.
+    Sprite find(const std::string& key) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return {};
+        Entry& e = it->second;
+        e.last_used = frame_;
+        lru_.splice(lru_.begin(), lru_, e.pos);
+        return sprite(e);
+    }
+
+    bool contains(const std::string& key) const { return entries_.count(key) != 0; }
+
+    // Copy 'px' into the atlas under 'key' (replacing any previous copy), evicting
+    // off-screen thumbnails if needed. Empty Sprite if it cannot be placed this frame.
+    Sprite insert(const std::string& key, const Pixels& px) {
+        if (!px.rgba || px.width <= 0 || px.height <= 0 || px.width > page_size_ || px.height > page_size_) return {};
+        erase(key);
+        Slot slot;
+        while (!allocate(px.width, px.height, slot)) {
+            if (!evict_one()) return {};
+        }
+        Page& page = *pages_[(std::size_t)slot.page];
+        if (ops_.update) ops_.update(page.tex, slot.x, slot.y, px);
+        ++page.used;
+        lru_.push_front(key);
+        Entry e;
+        e.slot = slot;
+        e.w = px.width;
+        e.h = px.height;
+        e.last_used = frame_;
+        e.pos = lru_.begin();
+        return sprite(entries_.emplace(key, e).first->second);
+    }
+
+    void erase(const std::string& key) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return;
+        release(it->second);
+        lru_.erase(it->second.pos);
+        entries_.erase(it);
+    }
+
+    // Destroy every page (before the renderer goes away).
+    void clear() {
+        for (auto& p : pages_) {
+            if (p && p->tex && ops_.destroy) ops_.destroy(p->tex);
+        }
+        pages_.clear();
+        entries_.clear();
+        lru_.clear();
+    }
+
+    std::size_t pages() const {
+        std::size_t n = 0;
+        for (auto& p : pages_) n += p ? 1 : 0;
+        return n;
+    }
+    std::size_t resident() const { return entries_.size(); }
+    std::uint64_t bytes() const { return (std::uint64_t)pages() * page_size_ * page_size_ * 4; }
+    std::uint64_t evictions() const { return evictions_; }
+
+private:
+    struct Span {
+        int x = 0, w = 0;
+    };
+    struct Shelf {
+        int y = 0, h = 0;
+        int x = 0;               // end of the packed part
+        std::vector<Span> holes; // freed slots left of x
+    };
+    struct Page {
+        Texture tex = 0;
+        int next_y = 0;
+        int used = 0;
+        std::vector<Shelf> shelves;
+    };
+    struct Slot {
+        int page = -1, shelf = -1;
+        int x = 0, y = 0;
+    };
+    struct Entry {
+        Slot slot;
+        int w = 0, h = 0;
+        std::uint64_t last_used = 0;
+        std::list<std::string>::iterator pos;
+    };
+
+    Sprite sprite(const Entry& e) const {
+        // Half-texel inset so linear filtering never reads a neighbouring thumbnail
+        const float inv = 1.0f / (float)page_size_;
+        Sprite s;
+        s.page = pages_[(std::size_t)e.slot.page]->tex;
+        s.u0 = ((float)e.slot.x + 0.5f) * inv;
+        s.v0 = ((float)e.slot.y + 0.5f) * inv;
+        s.u1 = ((float)(e.slot.x + e.w) - 0.5f) * inv;
+        s.v1 = ((float)(e.slot.y + e.h) - 0.5f) * inv;
+        return s;
+    }
+
+    // Shelves may be up to 25% taller than the item so near-equal heights share a shelf
+    static bool shelf_fits(const Shelf& s, int h) { return h <= s.h && s.h <= h + h / 4; }
+
+    bool allocate(int w, int h, Slot& out) {
+        for (std::size_t pi = 0; pi < pages_.size(); ++pi) {
+            if (!pages_[pi]) continue;
+            Page& p = *pages_[pi];
+            for (std::size_t si = 0; si < p.shelves.size(); ++si) {
+                Shelf& s = p.shelves[si];
+                if (!shelf_fits(s, h)) continue;
+                for (auto it = s.holes.begin(); it != s.holes.end(); ++it) {
+                    if (it->w < w) continue;
+                    out = Slot{(int)pi, (int)si, it->x, s.y};
+                    it->x += w;
+                    it->w -= w;
+                    if (it->w == 0) s.holes.erase(it);
+                    return true;
+                }
+                if (s.x + w <= page_size_) {
+                    out = Slot{(int)pi, (int)si, s.x, s.y};
+                    s.x += w;
+                    return true;
+                }
+            }
+            if (p.next_y + h <= page_size_) {
+                p.shelves.push_back(Shelf{p.next_y, h, w, {}});
+                out = Slot{(int)pi, (int)p.shelves.size() - 1, 0, p.next_y};
+                p.next_y += h;
+                return true;
+            }
+        }
+        if (pages() >= max_pages_ || !ops_.create) return false;
+        const Texture tex = ops_.create(page_size_);
+        if (!tex) return false;
+        auto page = std::make_unique<Page>();
+        page->tex = tex;
+        page->shelves.push_back(Shelf{0, h, w, {}});
+        page->next_y = h;
+        // Reuse a destroyed page's index so Slot::page stays small and stable
+        std::size_t pi = 0;
+        while (pi < pages_.size() && pages_[pi]) ++pi;
+        if (pi == pages_.size()) pages_.push_back(nullptr);
+        pages_[pi] = std::move(page);
+        out = Slot{(int)pi, 0, 0, 0};
+        return true;
+    }
+
+    void release(const Entry& e) {
+        Page& p = *pages_[(std::size_t)e.slot.page];
+        Shelf& s = p.shelves[(std::size_t)e.slot.shelf];
+        s.holes.push_back(Span{e.slot.x, e.w});
+        // Merge adjacent holes, then give a trailing hole back to the packed end
+        std::sort(s.holes.begin(), s.holes.end(), [](const Span& a, const Span& b){ return a.x < b.x; });
+        std::vector<Span> merged;
+        for (const Span& h : s.holes) {
+            if (!merged.empty() && merged.back().x + merged.back().w == h.x) merged.back().w += h.w;
+            else merged.push_back(h);
+        }
+        if (!merged.empty() && merged.back().x + merged.back().w == s.x) {
+            s.x = merged.back().x;
+            merged.pop_back();
+        }
+        s.holes = std::move(merged);
+        if (--p.used == 0) {
+            if (pages() > max_pages_) {
+                if (ops_.destroy) ops_.destroy(p.tex);
+                pages_[(std::size_t)e.slot.page].reset();
+            } else {
+                // Empty page: forget its shelves so any size fits again
+                p.shelves.clear();
+                p.next_y = 0;
+            }
+        }
+    }
+
+    // Drop the least recently drawn thumbnail not drawn in this or the previous frame.
+    bool evict_one() {
+        if (lru_.empty()) return false;
+        auto it = entries_.find(lru_.back());
+        if (it->second.last_used + 1 >= frame_) return false; // everything resident is on screen
+        const std::string key = std::move(lru_.back());
+        release(it->second);
+        lru_.pop_back();
+        entries_.erase(it);
+        ++evictions_;
+        if (on_evict_) on_evict_(key);
+        return true;
+    }
+
+    int page_size_;
+    std::uint64_t max_pages_ = 1;
+    PageOps ops_;
+    std::function<void(const std::string& key)> on_evict_;
+    std::vector<std::unique_ptr<Page>> pages_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // front = most recently drawn
+    std::uint64_t frame_ = 1;
+    std::uint64_t evictions_ = 0;
+};
+
+} // namespace covers
+} // namespace app
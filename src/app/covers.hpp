@@ -0,0 +1,400 @@
+#pragma once
+// Cover thumbnails (header-only): fetch -> decode -> downsample on worker threads,
+// texture upload on the UI thread.
+// Covers are fetched through the cache tier (cache::kNsCover), decoded to RGBA (WIC on
+// Windows), center-cropped to 16:9 and box-filtered down to card size. Only those
+// card-size buffers reach the UI thread, which copies at most kMaxUploadsPerFrame per
+// frame into the cover atlas (cover_atlas.hpp) so a burst of finished decodes cannot
+// stall a frame. Cards draw from the atlas pages using the returned UVs.
+// Full-size images never exist on the render thread.
+// Forum attachments are fetched at the smallest variant that covers the target width
+// (parser/attachments.hpp): the /thumb/ image for cards, the original for larger views.
+// Finished thumbnails are also written to the thumbnail store (thumb_store.hpp); later
+// runs upload them straight from its memory mapping without fetching or decoding.
+// Each generated thumbnail also leaves a placeholder hash (placeholder.hpp) in the store's
+// placeholder index; cards paint it while the thumbnail is fetched, decoded or uploaded.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include "fetch/fetch.hpp"
+#include "cache_tier.hpp"
+#include "runtime.hpp"
+#include "thumb_store.hpp"
+#include "resample.hpp"
+#include "cover_atlas.hpp"
+#include "placeholder.hpp"
+#include "frame_scheduler.hpp"
+#include "../ui_constants.hpp"
+#include "../parser/attachments.hpp"
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <wincodec.h>
+#  pragma comment(lib, "windowscodecs.lib")
+#  pragma comment(lib, "ole32.lib")
+#endif
+
+namespace app {
+namespace covers {
+
+inline constexpr int kThumbWidth = ui_constants::kCardWidth;
+inline constexpr int kThumbHeight = ui_constants::kCardWidth * 9 / 16;
+inline constexpr int kDecodeWorkers = 2;
+inline constexpr int kMaxUploadsPerFrame = 2;
+inline constexpr std::uint32_t kMaxDecodeDim = 16384; // refuse absurd or corrupt headers
+inline constexpr std::size_t kMaxPlaceholders = 4096;   // decoded grids kept on the UI thread
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> rgba; // width * height * 4, rows top to bottom
+
+    Pixels pixels() const { return Pixels{width, height, rgba.empty() ? nullptr : rgba.data()}; }
+};
+
+namespace detail {
+#if defined(_WIN32)
+template <class T>
+struct ComRef {
+    T* p = nullptr;
+    ComRef() = default;
+    ComRef(const ComRef&) = delete;
+    ComRef& operator=(const ComRef&) = delete;
+    ~ComRef() { if (p) p->Release(); }
+    T* operator->() const { return p; }
+};
+#endif
+
+// Decode an encoded image (JPEG/PNG/WebP/... as supported by the platform) to RGBA.
+inline bool decode(const std::string& bytes, Image& out) {
+#if defined(_WIN32)
+    if (bytes.empty() || bytes.size() > 0xFFFFFFFFull) return false;
+    // Workers are plain threads: join the MTA for the duration of the call
+    const HRESULT co = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    struct CoGuard {
+        bool on;
+        ~CoGuard() { if (on) CoUninitialize(); }
+    } guard{SUCCEEDED(co)};
+
+    ComRef<IWICImagingFactory> factory;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory.p)))) return false;
+    ComRef<IWICStream> stream;
+    if (FAILED(factory->CreateStream(&stream.p))) return false;
+    if (FAILED(stream->InitializeFromMemory((BYTE*)bytes.data(), (DWORD)bytes.size()))) return false;
+    ComRef<IWICBitmapDecoder> decoder;
+    if (FAILED(factory->CreateDecoderFromStream(stream.p, nullptr, WICDecodeMetadataCacheOnDemand, &decoder.p))) return false;
+    ComRef<IWICBitmapFrameDecode> frame;
+    if (FAILED(decoder->GetFrame(0, &frame.p))) return false;
+    UINT w = 0, h = 0;
+    if (FAILED(frame->GetSize(&w, &h)) || w == 0 || h == 0 || w > kMaxDecodeDim || h > kMaxDecodeDim) return false;
+    ComRef<IWICFormatConverter> conv;
+    if (FAILED(factory->CreateFormatConverter(&conv.p))) return false;
+    if (FAILED(conv->Initialize(frame.p, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0,
+                                WICBitmapPaletteTypeCustom))) return false;
+    out.width = (int)w;
+    out.height = (int)h;
+    out.rgba.resize((std::size_t)w * h * 4);
+    return SUCCEEDED(conv->CopyPixels(nullptr, w * 4, (UINT)out.rgba.size(), out.rgba.data()));
+#else
+    // No system codec on this platform; covers stay as placeholders
+    (void)bytes; (void)out;
+    return false;
+#endif
+}
+
+} // namespace detail
+
+// Center-crop 'src' to the aspect of w x h and box-filter it to exactly w x h
+// (resample.hpp; SIMD where available).
+inline Image make_thumbnail(const Image& src, int w = kThumbWidth, int h = kThumbHeight) {
+    Image out;
+    if (src.width <= 0 || src.height <= 0 || w <= 0 || h <= 0) return out;
+    int cw = src.width, ch = src.height;
+    if ((long long)cw * h > (long long)ch * w) cw = (int)((long long)ch * w / h);
+    else ch = (int)((long long)cw * h / w);
+    if (cw < 1) cw = 1;
+    if (ch < 1) ch = 1;
+    const int x0 = (src.width - cw) / 2, y0 = (src.height - ch) / 2;
+
+    out.width = w;
+    out.height = h;
+    out.rgba.resize((std::size_t)w * h * 4);
+    resample::rgba8(src.rgba.data(), src.width, src.height, (std::size_t)src.width * 4, resample::Rect{x0, y0, cw, ch},
+                    out.rgba.data(), w, h, (std::size_t)w * 4, resample::Filter::Box);
+    return out;
+}
+
+// Fetch + decode 'url' for display at 'target_width' pixels. The source is the forum
+// thumb when it is large enough, falling back to the original if the thumb is missing.
+// Runs on a worker thread; false on failure.
+inline bool load_image(const std::string& url, int target_width, Image& out) {
+    // Disk tier only: decoded pixels are what stays in memory, not the encoded original
+    const cache::Options opt{false, true, cache::kNsCover};
+    const std::string src = parser::attachments::source_for(url, target_width);
+    cache::Value bytes = fetch::get_cached_sync(src, {}, opt);
+    if (bytes && detail::decode(*bytes, out)) return true;
+    if (src == url) return false;
+    bytes = fetch::get_cached_sync(url, {}, opt);
+    return bytes && detail::decode(*bytes, out);
+}
+
+// Fetch + decode + downsample one cover and persist the result with its placeholder
+// hash (also returned in 'hash'). Runs on a worker thread; empty Image on failure.
+inline Image load_thumbnail(const std::string& url, placeholder::Hash* hash = nullptr) {
+    Image full;
+    if (!load_image(url, kThumbWidth, full)) return {};
+    Image thumb = make_thumbnail(full);
+    const placeholder::Hash ph = placeholder::encode(thumb.rgba.data(), thumb.width, thumb.height, (std::size_t)thumb.width * 4);
+    thumbs::put(url, thumb.width, thumb.height, thumb.rgba);
+    if (ph) thumbs::put_placeholder(url, ph.bytes);
+    if (hash) *hash = ph;
+    return thumb;
+}
+
+// Owns the url -> atlas mapping. set_renderer(), sprite(), pump() and clear() are
+// UI-thread only.
+class Pipeline {
+public:
+    void set_renderer(PageOps ops) { atlas_.set_ops(std::move(ops)); }
+
+    // GPU memory for atlas pages; takes effect as pages empty.
+    void set_budget(std::uint64_t bytes) { atlas_.set_budget(bytes); }
+
+    // Atlas placement for 'url'; empty while loading (or failed). A cover that is not
+    // resident (first use, or evicted) is queued again: from the thumbnail store when it
+    // is there, otherwise as a fetch + decode. 'priority' orders decodes (lower first:
+    // 0 = on screen, otherwise distance to the viewport); a queued decode not requested
+    // again during a frame is cancelled at the next pump(). The cover's placeholder is
+    // looked up before anything is queued.
+    Sprite sprite(const std::string& url, int priority = 0) {
+        if (url.empty()) return {};
+        if (Sprite s = atlas_.find(url)) return s;
+        touch_placeholder(url);
+        State& st = states_[url];
+        if (st == State::Failed) return {};
+        auto w = wanted_.try_emplace(url, priority).first;
+        w->second = (std::min)(w->second, priority);
+        if (st == State::Loading) return {};
+        st = State::Loading;
+        if (thumbs::Thumb t = thumbs::get(url)) {
+            std::lock_guard<std::mutex> lk(m_);
+            ready_.push_back(Done{url, {}, std::move(t), {}});
+        } else {
+            enqueue(url, priority);
+        }
+        return {};
+    }
+
+    // Blurred stand-in for a cover that is not resident yet; null if none is known
+    // (never generated, or stored before placeholders existed). Valid after sprite()
+    // was called for 'url' this frame.
+    const placeholder::Grid* placeholder(const std::string& url) const {
+        auto it = placeholders_.find(url);
+        return it == placeholders_.end() || !it->second.valid ? nullptr : &it->second.grid;
+    }
+
+    // Copy finished thumbnails into the atlas, at most 'max_uploads' this frame.
+    // Call once per frame before any card is drawn.
+    void pump(int max_uploads = kMaxUploadsPerFrame) {
+        atlas_.begin_frame();
+        ++frame_;
+        trim_placeholders();
+        reprioritize();
+        for (int n = 0; n < max_uploads; ++n) {
+            Done done;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (ready_.empty()) return;
+                done = std::move(ready_.front());
+                ready_.pop_front();
+            }
+            auto it = states_.find(done.url);
+            if (it == states_.end()) continue;
+            remember_placeholder(done.url, done.hash);
+            const Pixels px = done.pixels();
+            if (!px.rgba) {
+                it->second = State::Failed;
+                --n; // failed loads cost no upload
+                continue;
+            }
+            // If everything resident is on screen the insert fails; retried when next drawn
+            atlas_.insert(done.url, px);
+            it->second = State::Idle;
+        }
+    }
+
+    // Destroy the atlas pages (before the renderer goes away). Loads in flight are dropped.
+    void clear() {
+        atlas_.clear();
+        states_.clear();
+        wanted_.clear();
+        placeholders_.clear();
+        std::lock_guard<std::mutex> lk(m_);
+        jobs_.clear();
+        ready_.clear();
+        ++generation_;
+    }
+
+    // Finished loads are waiting for pump(); the next frame has work to do
+    bool has_ready() {
+        std::lock_guard<std::mutex> lk(m_);
+        return !ready_.empty();
+    }
+
+    const Atlas& atlas() const { return atlas_; }
+    std::uint64_t cancelled() const { return cancelled_; }
+
+private:
+    enum class State {
+        Idle,    // resident, or evicted and reloaded on next use
+        Loading, // queued for decode or upload
+        Failed,  // fetch/decode failed; not retried this session
+    };
+
+    // A finished thumbnail: freshly decoded, or mapped from the thumbnail store
+    struct Done {
+        std::string url;
+        Image image;
+        thumbs::Thumb stored;
+        placeholder::Hash hash; // fresh decodes only; stored ones come from the index
+
+        Pixels pixels() const {
+            if (stored) return Pixels{stored.width, stored.height, stored.rgba};
+            return image.pixels();
+        }
+    };
+
+    // Decoded placeholder, or a remembered miss
+    struct Placeholder {
+        placeholder::Grid grid;
+        bool valid = false;
+        std::uint64_t used = 0; // frame_ of the last sprite() request
+    };
+
+    // Load the placeholder of a cover that is about to be drawn without its thumbnail
+    void touch_placeholder(const std::string& url) {
+        auto [it, added] = placeholders_.try_emplace(url);
+        it->second.used = frame_;
+        if (!added) return;
+        const cache::pack::View v = thumbs::get_placeholder(url);
+        const placeholder::Hash h = v ? placeholder::from_bytes(v.data) : placeholder::Hash{};
+        if (h) {
+            it->second.grid = placeholder::decode(h);
+            it->second.valid = true;
+        }
+    }
+
+    void remember_placeholder(const std::string& url, const placeholder::Hash& h) {
+        if (!h) return;
+        Placeholder& p = placeholders_[url];
+        if (p.valid) return;
+        p.grid = placeholder::decode(h);
+        p.valid = true;
+        p.used = frame_;
+    }
+
+    // Over the cap, forget placeholders not requested in the last frame; they are read
+    // from the index again if their card comes back
+    void trim_placeholders() {
+        if (placeholders_.size() <= kMaxPlaceholders) return;
+        for (auto it = placeholders_.begin(); it != placeholders_.end();) {
+            it = it->second.used + 1 < frame_ ? placeholders_.erase(it) : std::next(it);
+        }
+    }
+
+    struct Job {
+        std::string url;
+        int priority = 0;
+    };
+
+    void enqueue(const std::string& url, int priority) {
+        std::lock_guard<std::mutex> lk(m_);
+        jobs_.push_back(Job{url, priority});
+        if (workers_ >= kDecodeWorkers) return;
+        ++workers_;
+        app::runtime::schedule([this]{ work(); });
+    }
+
+    // Apply last frame's requests to the queue: refresh priorities and cancel jobs for
+    // covers that were not requested (scrolled out of the prefetch window). A cancelled
+    // cover goes back to Idle and is queued again if it comes back into view.
+    void reprioritize() {
+        std::vector<std::string> cancelled;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            for (auto it = jobs_.begin(); it != jobs_.end();) {
+                auto w = wanted_.find(it->url);
+                if (w == wanted_.end()) {
+                    cancelled.push_back(std::move(it->url));
+                    it = jobs_.erase(it);
+                } else {
+                    it->priority = w->second;
+                    ++it;
+                }
+            }
+        }
+        for (const auto& url : cancelled) {
+            auto it = states_.find(url);
+            if (it != states_.end() && it->second == State::Loading) it->second = State::Idle;
+        }
+        cancelled_ += cancelled.size();
+        wanted_.clear();
+    }
+
+    void work() {
+        for (;;) {
+            std::string url;
+            std::uint64_t gen = 0;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (jobs_.empty()) {
+                    --workers_;
+                    return;
+                }
+                // Nearest to the viewport first; the queue holds at most a few screens of covers
+                auto best = std::min_element(jobs_.begin(), jobs_.end(),
+                                             [](const Job& a, const Job& b){ return a.priority < b.priority; });
+                url = std::move(best->url);
+                jobs_.erase(best);
+                gen = generation_;
+            }
+            placeholder::Hash hash;
+            Image thumb = load_thumbnail(url, &hash);
+            std::lock_guard<std::mutex> lk(m_);
+            if (gen == generation_) {
+                ready_.push_back(Done{std::move(url), std::move(thumb), {}, hash});
+                frame_scheduler::scheduler().request_redraw();
+            }
+        }
+    }
+
+    Atlas atlas_;                                   // UI thread only
+    std::unordered_map<std::string, State> states_; // UI thread only
+    std::unordered_map<std::string, int> wanted_;   // UI thread only: requests since the last pump
+    std::unordered_map<std::string, Placeholder> placeholders_; // UI thread only
+    std::uint64_t frame_ = 0;                       // UI thread only: pump() count
+    std::uint64_t cancelled_ = 0;                   // UI thread only
+
+    std::mutex m_; // guards everything below
+    std::vector<Job> jobs_;
+    std::deque<Done> ready_;
+    int workers_ = 0;
+    std::uint64_t generation_ = 0;
+};
+
+inline Pipeline& pipeline() {
+    static Pipeline p;
+    return p;
+}
+
+} // namespace covers
+} // namespace app
@@ -0,0 +1,297 @@
+#pragma once
+// Append-only journal for the downloads queue (header-only).
+// One record per line, tab-separated, fields escaped (\t \n \\):
+//   E <id> <title> <target_dir> <size_bytes> <url>...   item enqueued
+//   P <id> <bytes_done> <bytes_total>                    progress (throttled)
+//   S <id> <status> <message>                           status change
+//   H <id> <sha256>                                      expected content hash (optional)
+// Replay folds records into the latest state per id; a torn last line (crash mid-write)
+// is ignored. Compaction rewrites one E/P/S triple per live item into a temp file and
+// renames it over the journal.
+// Progress records are coalesced per id (byte/time thresholds) and left in the stdio
+// buffer; status changes flush. Resume correctness does not depend on P records:
+// the partial file on disk is the source of truth for how much was downloaded.
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+#include <fstream>
+#include <system_error>
+#include <filesystem>
+
+namespace app {
+namespace downloads {
+
+namespace journal {
+
+inline constexpr std::uint64_t kProgressBytesStep = 4ull * 1024 * 1024;
+inline constexpr std::chrono::milliseconds kProgressInterval{2000};
+inline constexpr std::size_t kCompactAfterRecords = 4096;
+inline constexpr std::size_t kKeepFinished = 200; // terminal items kept in history on compaction
+
+namespace detail {
+inline void append_escaped(std::string& out, const std::string& s) {
+    for (char c : s) {
+        switch (c) {
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\\': out += "\\\\"; break;
+            default:   out.push_back(c); break;
+        }
+    }
+}
+
+inline std::string unescape(const char* b, const char* e) {
+    std::string out;
+    out.reserve((std::size_t)(e - b));
+    for (const char* p = b; p < e; ++p) {
+        if (*p == '\\' && p + 1 < e) {
+            ++p;
+            switch (*p) {
+                case 't': out.push_back('\t'); break;
+                case 'n': out.push_back('\n'); break;
+                case 'r': out.push_back('\r'); break;
+                default:  out.push_back(*p); break;
+            }
+        } else {
+            out.push_back(*p);
+        }
+    }
+    return out;
+}
+
+inline std::vector<std::string> split_fields(const std::string& line) {
+    std::vector<std::string> f;
+    const char* b = line.data();
+    const char* end = b + line.size();
+    const char* s = b;
+    for (const char* p = b; p <= end; ++p) {
+        if (p == end || *p == '\t') {
+            f.push_back(unescape(s, p));
+            s = p + 1;
+        }
+    }
+    return f;
+}
+
+inline std::filesystem::path u8path(const std::string& s) {
+    return std::filesystem::path(std::u8string(s.begin(), s.end()));
+}
+
+inline std::uint64_t to_u64(const std::string& s) {
+    std::uint64_t v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') break;
+        v = v * 10 + (std::uint64_t)(c - '0');
+    }
+    return v;
+}
+} // namespace detail
+
+// Latest known state of one journaled item.
+template <typename ItemT, typename ProgressT>
+struct Entry {
+    ItemT item;
+    ProgressT progress;
+};
+
+// Journal is not internally synchronized: the downloads Manager calls it under its own mutex.
+template <typename ItemT, typename ProgressT, typename StatusT>
+class Journal {
+public:
+    using Id = std::size_t;
+    using EntryT = Entry<ItemT, ProgressT>;
+
+    ~Journal() { close(); }
+
+    // Read existing records (if any) and open the file for appending.
+    // Returns the replayed entries ordered by id, without the history dropped by compaction.
+    std::map<Id, EntryT> open(const std::string& path) {
+        close();
+        path_ = path;
+        std::map<Id, EntryT> entries = replay(path);
+        // Start from a compact file so replay stays fast regardless of history length
+        write_snapshot(entries);
+        file_ = std::fopen(path_.c_str(), "ab");
+        if (file_) std::setvbuf(file_, nullptr, _IOFBF, 64 * 1024);
+        return entries;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    void close() {
+        if (file_) {
+            std::fflush(file_);
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    void on_enqueue(Id id, const ItemT& it) {
+        live_[id].item = it;
+        std::string line = "E\t" + std::to_string(id) + "\t";
+        detail::append_escaped(line, it.title);
+        line += '\t';
+        detail::append_escaped(line, it.target_dir);
+        line += '\t';
+        line += std::to_string(it.size_bytes);
+        for (const auto& u : it.urls) {
+            line += '\t';
+            detail::append_escaped(line, u);
+        }
+        // Separate record so journals written before hashes existed replay unchanged
+        if (!it.sha256.empty()) line += "\nH\t" + std::to_string(id) + "\t" + it.sha256;
+        append(line, true);
+        maybe_compact();
+    }
+
+    // Called on every progress mutation; decides whether anything is worth writing.
+    // Ids not journaled (never enqueued, or dropped from history) are ignored.
+    void on_progress(Id id, const ProgressT& p) {
+        auto found = live_.find(id);
+        if (found == live_.end()) return;
+        auto& st = found->second;
+        const bool status_changed = (p.status != st.progress.status) || (p.message != st.progress.message && is_terminal(p.status));
+        const auto now = std::chrono::steady_clock::now();
+        const bool bytes_due = p.bytes_done != st.progress.bytes_done &&
+                               (p.bytes_done >= st.last_bytes + kProgressBytesStep ||
+                                p.bytes_done < st.last_bytes ||
+                                now - st.last_write >= kProgressInterval);
+        if (bytes_due || (status_changed && p.bytes_done != st.last_bytes)) {
+            append("P\t" + std::to_string(id) + "\t" + std::to_string(p.bytes_done) + "\t" + std::to_string(p.bytes_total), false);
+            st.last_bytes = p.bytes_done;
+            st.last_write = now;
+        }
+        if (status_changed) {
+            std::string line = "S\t" + std::to_string(id) + "\t" + std::to_string((int)p.status) + "\t";
+            detail::append_escaped(line, p.message);
+            append(line, true);
+        }
+        st.progress = p;
+        maybe_compact();
+    }
+
+private:
+    struct Live {
+        ItemT item{};
+        ProgressT progress{};
+        std::uint64_t last_bytes = 0;
+        std::chrono::steady_clock::time_point last_write{};
+    };
+
+    static bool is_terminal(StatusT s) {
+        return s == StatusT::Completed || s == StatusT::Failed || s == StatusT::Canceled;
+    }
+
+    void append(const std::string& line, bool flush) {
+        if (!file_) return;
+        std::fwrite(line.data(), 1, line.size(), file_);
+        std::fputc('\n', file_);
+        if (flush) std::fflush(file_);
+        ++records_;
+    }
+
+    // Once the record has been applied to live_: compaction rebuilds live_ from scratch
+    void maybe_compact() {
+        if (records_ >= kCompactAfterRecords && !snapshotting_) compact();
+    }
+
+    static std::map<Id, EntryT> replay(const std::string& path) {
+        std::map<Id, EntryT> out;
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        if (!in.is_open()) return out;
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::size_t pos = 0;
+        while (pos < data.size()) {
+            std::size_t nl = data.find('\n', pos);
+            if (nl == std::string::npos) break; // torn tail
+            std::string line = data.substr(pos, nl - pos);
+            pos = nl + 1;
+            if (line.size() < 3) continue;
+            auto f = detail::split_fields(line);
+            if (f.size() < 2) continue;
+            Id id = (Id)detail::to_u64(f[1]);
+            if (f[0] == "E" && f.size() >= 5) {
+                EntryT& e = out[id];
+                e.item.title = f[2];
+                e.item.target_dir = f[3];
+                e.item.size_bytes = detail::to_u64(f[4]);
+                e.item.urls.assign(f.begin() + 5, f.end());
+            } else if (f[0] == "P" && f.size() >= 4) {
+                auto it = out.find(id);
+                if (it == out.end()) continue;
+                it->second.progress.bytes_done = detail::to_u64(f[2]);
+                it->second.progress.bytes_total = detail::to_u64(f[3]);
+            } else if (f[0] == "H" && f.size() >= 3) {
+                auto it = out.find(id);
+                if (it == out.end()) continue;
+                it->second.item.sha256 = f[2];
+            } else if (f[0] == "S" && f.size() >= 3) {
+                auto it = out.find(id);
+                if (it == out.end()) continue;
+                it->second.progress.status = (StatusT)(int)detail::to_u64(f[2]);
+                it->second.progress.message = f.size() >= 4 ? f[3] : std::string();
+            }
+        }
+        return out;
+    }
+
+    // Rewrite the journal as a snapshot of 'entries' (temp file + rename). The oldest
+    // finished items beyond kKeepFinished are dropped, from 'entries' too.
+    void write_snapshot(std::map<Id, EntryT>& entries) {
+        std::size_t finished = 0;
+        for (const auto& kv : entries) if (is_terminal(kv.second.progress.status)) ++finished;
+        std::size_t to_drop = finished > kKeepFinished ? finished - kKeepFinished : 0;
+        for (auto it = entries.begin(); it != entries.end() && to_drop > 0;) {
+            if (is_terminal(it->second.progress.status)) {
+                it = entries.erase(it);
+                --to_drop;
+            } else {
+                ++it;
+            }
+        }
+
+        live_.clear();
+        const std::string tmp = path_ + ".tmp";
+        std::FILE* f = std::fopen(tmp.c_str(), "wb");
+        if (!f) return;
+        std::FILE* saved = file_;
+        file_ = f;
+        snapshotting_ = true;
+        for (const auto& kv : entries) {
+            on_enqueue(kv.first, kv.second.item);
+            on_progress(kv.first, kv.second.progress);
+        }
+        snapshotting_ = false;
+        std::fflush(f);
+        std::fclose(f);
+        file_ = saved;
+        records_ = 0;
+
+        std::error_code ec;
+        std::filesystem::rename(detail::u8path(tmp), detail::u8path(path_), ec);
+    }
+
+    void compact() {
+        std::map<Id, EntryT> entries;
+        for (const auto& kv : live_) entries[kv.first] = EntryT{kv.second.item, kv.second.progress};
+        close();
+        write_snapshot(entries);
+        file_ = std::fopen(path_.c_str(), "ab");
+        if (file_) std::setvbuf(file_, nullptr, _IOFBF, 64 * 1024);
+    }
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    std::size_t records_ = 0;
+    bool snapshotting_ = false;
+    std::map<Id, Live> live_;
+};
+
+} // namespace journal
+} // namespace downloads
+} // namespace app
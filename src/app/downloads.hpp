@@ -1,5 +1,9 @@
 #pragma once
 // Downloads manager: queue, progress, cancel. WinHTTP-based streaming into files (header-only impl)
+// Transient failures are retried with jittered backoff and resumed via Range; see retry.hpp.
+// The HTTP layer sits behind Transport, so the retry loop runs the same against WinHTTP
+// and against the fault-injecting transport of the tests.
+// Payloads are hashed while streaming and deduplicated through blob_store.hpp.
 
 #include <string>
 #include <vector>
@@ -12,6 +16,15 @@
 #include <map>
 #include <functional>
 #include <set>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+#include "host_stats.hpp"
+#include "retry.hpp"
+#include "download_journal.hpp"
+#include "blob_store.hpp"
+#include "hash.hpp"
 
 #if defined(_WIN32)
 #  include <windows.h>
@@ -26,6 +39,7 @@ struct Item {
     std::string target_dir;
     std::vector<std::string> urls; // use first that works
     std::uint64_t size_bytes = 0;
+    std::string sha256; // expected content hash (hex), optional; enables skipping known blobs
 };
 
 enum class Status {
@@ -44,6 +58,36 @@ struct Progress {
     std::string message;
 };
 
+// One HTTP GET as the retry loop sees it. The platform transport (WinHTTP on Windows)
+// performs it; tests inject failures through Manager's constructor.
+struct Request {
+    std::string url;
+    std::uint64_t offset = 0;           // sent as "Range: bytes=<offset>-" when non-zero
+    std::uint32_t stall_timeout_s = 30; // fail a receive that sees no bytes for this long
+};
+
+struct Head {
+    int status = 0;
+    bool has_length = false;
+    std::uint64_t content_length = 0; // of this response (the remaining part for a 206)
+    std::string retry_after;          // raw Retry-After value, empty if absent
+};
+
+enum class Fault {
+    None,      // the body was read to its end (possibly shorter than announced)
+    Fatal,     // the request could not be built (bad URL, no session); try the next mirror
+    Transient, // connect/send/receive failed or stalled; worth retrying the same URL
+    Stopped    // a callback returned false
+};
+
+struct Transport {
+    using OnHead = std::function<bool(const Head&)>;
+    using OnData = std::function<bool(const char*, std::size_t)>;
+    // Perform 'req': on_head once when the headers arrive, then on_data per chunk of the
+    // body. Either callback returns false to stop. 'error' describes a fault.
+    std::function<Fault(const Request& req, const OnHead& on_head, const OnData& on_data, std::string& error)> get;
+};
+
 namespace detail {
 #if defined(_WIN32)
 inline std::wstring to_wide(const std::string& s) {
@@ -63,18 +107,220 @@ inline std::string join_path(const std::string& a, const std::string& b) {
     return a + sep + b;
 }
 
+inline std::uint64_t file_size(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return 0;
+    auto pos = in.tellg();
+    return pos > 0 ? (std::uint64_t)pos : 0;
+}
+
+// Content-Length header value as a 64-bit count; false if empty, signed or not all digits
+inline bool parse_content_length(const std::string& v, std::uint64_t& out) {
+    std::size_t b = 0, e = v.size();
+    while (b < e && (v[b] == ' ' || v[b] == '\t')) ++b;
+    while (e > b && (v[e - 1] == ' ' || v[e - 1] == '\t' || v[e - 1] == '\0')) --e;
+    if (b == e || e - b > 19) return false; // 19 digits always fit in 64 bits
+    std::uint64_t n = 0;
+    for (std::size_t i = b; i < e; ++i) {
+        if (v[i] < '0' || v[i] > '9') return false;
+        n = n * 10 + (std::uint64_t)(v[i] - '0');
+    }
+    out = n;
+    return true;
+}
+
+// Streaming SHA-256 of a download: full content plus the blob_store prefix hash
+struct HashState {
+    hash::Sha256 full;
+    hash::Sha256 prefix;
+    std::string prefix_hex; // set once kPrefixBytes have been fed (or at finish for short files)
+
+    void reset() {
+        full.reset();
+        prefix.reset();
+        prefix_hex.clear();
+    }
+
+    // Returns true when this call completed the prefix
+    bool feed(const char* p, std::size_t n) {
+        const std::uint64_t before = full.size();
+        full.update(p, n);
+        if (before >= blob_store::kPrefixBytes) return false;
+        std::size_t take = (std::size_t)(std::min)((std::uint64_t)n, blob_store::kPrefixBytes - before);
+        prefix.update(p, take);
+        if (before + take < blob_store::kPrefixBytes) return false;
+        prefix_hex = hash::to_hex(prefix.finish());
+        return true;
+    }
+
+    // Bring the hash in line with the first 'bytes' of an existing partial file
+    bool rehash(const std::string& path, std::uint64_t bytes) {
+        reset();
+        if (bytes == 0) return true;
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+        std::string buf(1 << 16, '\0');
+        while (full.size() < bytes) {
+            std::size_t want = (std::size_t)(std::min)((std::uint64_t)buf.size(), bytes - full.size());
+            in.read(&buf[0], (std::streamsize)want);
+            std::size_t got = (std::size_t)in.gcount();
+            if (got == 0) return false;
+            feed(buf.data(), got);
+        }
+        return true;
+    }
+};
+
 inline std::string filename_from_url(const std::string& url) {
     auto pos = url.find_last_of("/\\");
     if (pos == std::string::npos) return url;
     return url.substr(pos + 1);
 }
+
+#if defined(_WIN32)
+inline Fault winhttp_get(const Request& req, const Transport::OnHead& on_head, const Transport::OnData& on_data,
+                         std::string& error) {
+    // Crack URL
+    std::wstring urlW = to_wide(req.url);
+    URL_COMPONENTS uc{};
+    uc.dwStructSize = sizeof(uc);
+    std::wstring scheme(16, L'\0'), host(256, L'\0'), path(2048, L'\0'), extra(2048, L'\0');
+    uc.lpszScheme = &scheme[0]; uc.dwSchemeLength = (DWORD)scheme.size();
+    uc.lpszHostName = &host[0]; uc.dwHostNameLength = (DWORD)host.size();
+    uc.lpszUrlPath  = &path[0]; uc.dwUrlPathLength  = (DWORD)path.size();
+    uc.lpszExtraInfo= &extra[0]; uc.dwExtraInfoLength= (DWORD)extra.size();
+
+    if (!WinHttpCrackUrl(urlW.c_str(), 0, 0, &uc)) {
+        error = "CrackUrl failed";
+        return Fault::Fatal;
+    }
+    std::wstring hostW(uc.lpszHostName, uc.dwHostNameLength);
+    INTERNET_PORT port = uc.nPort;
+    bool isHttps = (uc.nScheme == INTERNET_SCHEME_HTTPS);
+
+    std::wstring fullPath;
+    fullPath.assign(uc.lpszUrlPath, uc.dwUrlPathLength);
+    if (uc.dwExtraInfoLength) fullPath.append(uc.lpszExtraInfo, uc.dwExtraInfoLength);
+
+    struct Handles {
+        HINTERNET session = nullptr, connect = nullptr, request = nullptr;
+        ~Handles() {
+            if (request) WinHttpCloseHandle(request);
+            if (connect) WinHttpCloseHandle(connect);
+            if (session) WinHttpCloseHandle(session);
+        }
+    } h;
+
+    h.session = WinHttpOpen(L"F95ManagerCpp/1.0",
+                            WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
+                            WINHTTP_NO_PROXY_NAME,
+                            WINHTTP_NO_PROXY_BYPASS, 0);
+    if (!h.session) { error = "Open session failed"; return Fault::Fatal; }
+
+    h.connect = WinHttpConnect(h.session, hostW.c_str(), port, 0);
+    if (!h.connect) { error = "Connect failed"; return Fault::Transient; }
+
+    h.request = WinHttpOpenRequest(h.connect, L"GET", fullPath.c_str(),
+                                   nullptr, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                   isHttps ? WINHTTP_FLAG_SECURE : 0);
+    if (!h.request) { error = "OpenRequest failed"; return Fault::Fatal; }
+
+    // Stall watchdog: a receive that sees no bytes for stall_timeout_s fails with
+    // ERROR_WINHTTP_TIMEOUT, which the caller treats as transient and reconnects with Range.
+    WinHttpSetTimeouts(h.request, 0, 30000, 30000, (int)(req.stall_timeout_s * 1000));
+
+    if (req.offset > 0) {
+        std::wstring range = L"Range: bytes=" + std::to_wstring(req.offset) + L"-";
+        WinHttpAddRequestHeaders(h.request, range.c_str(), (ULONG)-1L, WINHTTP_ADDREQ_FLAG_ADD);
+    }
+
+    if (!WinHttpSendRequest(h.request, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0)) {
+        error = "SendRequest failed";
+        return Fault::Transient;
+    }
+    if (!WinHttpReceiveResponse(h.request, nullptr)) {
+        error = "ReceiveResponse failed";
+        return Fault::Transient;
+    }
+
+    Head head;
+    DWORD statusCode = 0, ssize = sizeof(statusCode);
+    WinHttpQueryHeaders(h.request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                        WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &ssize, WINHTTP_NO_HEADER_INDEX);
+    head.status = (int)statusCode;
+
+    wchar_t ra[128] = {0};
+    DWORD ra_size = sizeof(ra);
+    if (WinHttpQueryHeaders(h.request, WINHTTP_QUERY_RETRY_AFTER, WINHTTP_HEADER_NAME_BY_INDEX,
+                            ra, &ra_size, WINHTTP_NO_HEADER_INDEX)) {
+        std::wstring raw(ra, ra_size / sizeof(wchar_t));
+        head.retry_after.assign(raw.begin(), raw.end());
+    }
+
+    // Content-Length queried as text: WINHTTP_QUERY_FLAG_NUMBER yields a 32-bit DWORD and
+    // wraps at 4 GB.
+    wchar_t len_buf[32] = {0};
+    DWORD size = sizeof(len_buf);
+    if (WinHttpQueryHeaders(h.request, WINHTTP_QUERY_CONTENT_LENGTH, WINHTTP_HEADER_NAME_BY_INDEX,
+                            len_buf, &size, WINHTTP_NO_HEADER_INDEX)) {
+        std::wstring raw(len_buf, size / sizeof(wchar_t));
+        head.has_length = parse_content_length(std::string(raw.begin(), raw.end()), head.content_length);
+    }
+    if (!on_head(head)) return Fault::Stopped;
+
+    std::string chunk;
+    for (;;) {
+        DWORD avail = 0;
+        if (!WinHttpQueryDataAvailable(h.request, &avail)) {
+            error = GetLastError() == ERROR_WINHTTP_TIMEOUT ? "Stalled" : "Read failed";
+            return Fault::Transient;
+        }
+        if (avail == 0) return Fault::None;
+        chunk.resize(avail);
+        DWORD read = 0;
+        if (!WinHttpReadData(h.request, &chunk[0], avail, &read)) {
+            error = GetLastError() == ERROR_WINHTTP_TIMEOUT ? "Stalled" : "Read failed";
+            return Fault::Transient;
+        }
+        if (!on_data(chunk.data(), read)) return Fault::Stopped;
+    }
+}
+#endif
 } // namespace detail
 
+// Transport used by the global manager: WinHTTP on Windows, unsupported elsewhere.
+inline Transport default_transport() {
+    Transport t;
+#if defined(_WIN32)
+    t.get = detail::winhttp_get;
+#else
+    t.get = [](const Request&, const Transport::OnHead&, const Transport::OnData&, std::string& error) {
+        error = "Downloads are not supported on this platform";
+        return Fault::Fatal;
+    };
+#endif
+    return t;
+}
+
+// Normalize a user-supplied SHA-256 (hex, any case, surrounding spaces) for Item::sha256.
+// Returns empty if it is not exactly 64 hex digits.
+inline std::string parse_sha256(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        if (c >= 'A' && c <= 'F') c = (char)(c - 'A' + 'a');
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return {};
+        out.push_back(c);
+    }
+    return out.size() == 64 ? out : std::string();
+}
+
 class Manager {
 public:
     using Id = std::size_t;
 
-    Manager() : stop_(false) {
+    explicit Manager(Transport transport = default_transport(), retry::Policy policy = retry::default_policy())
+        : stop_(false), transport_(std::move(transport)), policy_(policy) {
         worker_ = std::thread([this]{ this->run(); });
     }
 
@@ -91,7 +337,10 @@ public:
         std::lock_guard<std::mutex> lk(m_);
         Id id = ++last_id_;
         items_[id] = item;
+        // Try the historically fastest/most reliable mirrors first
+        host_stats::rank_urls(items_[id].urls);
         progresses_[id] = Progress{};
+        journal_.on_enqueue(id, items_[id]);
         queue_.push_back(id);
         cv_.notify_all();
         return id;
@@ -104,6 +353,40 @@ public:
         return true;
     }
 
+    // Persist the queue in an append-only journal at 'path' and restore what it holds
+    // (finished items only as far as the journal keeps their history). Unfinished items
+    // are re-queued; their partial files are resumed via Range. Returns the number of
+    // items resumed.
+    std::size_t open_journal(const std::string& path) {
+        std::lock_guard<std::mutex> lk(m_);
+        auto entries = journal_.open(path);
+        std::size_t resumed = 0;
+        for (auto& kv : entries) {
+            Id id = kv.first;
+            if (items_.count(id)) continue;
+            items_[id] = std::move(kv.second.item);
+            Progress p = kv.second.progress;
+            if (p.status == Status::Queued || p.status == Status::Running || p.status == Status::Paused) {
+                p.status = Status::Queued;
+                p.message = "Resumed";
+                queue_.push_back(id);
+                resumed_.insert(id);
+                journal_.on_progress(id, p);
+                ++resumed;
+            }
+            progresses_[id] = p;
+            if (id > last_id_) last_id_ = id;
+        }
+        cv_.notify_all();
+        return resumed;
+    }
+
+    // Snapshot of all known items (journaled history plus this session), ordered by id.
+    std::vector<std::pair<Id, Item>> list() const {
+        std::lock_guard<std::mutex> lk(m_);
+        return std::vector<std::pair<Id, Item>>(items_.begin(), items_.end());
+    }
+
     Progress query(Id id) const {
         std::lock_guard<std::mutex> lk(m_);
         auto it = progresses_.find(id);
@@ -122,6 +405,7 @@ private:
                 next = queue_.front();
                 queue_.erase(queue_.begin());
                 progresses_[next].status = Status::Running;
+                journal_.on_progress(next, progresses_[next]);
             }
 
             download_one(next);
@@ -138,141 +422,261 @@ private:
         auto it = progresses_.find(id);
         if (it != progresses_.end()) {
             fn(it->second);
+            journal_.on_progress(id, it->second);
         }
     }
 
+    // Canceled by the user. Shutdown is not a cancel: an item interrupted by it stays
+    // Running in the journal and resumes on the next start.
     bool is_canceled(Id id) {
         std::lock_guard<std::mutex> lk(m_);
         return canceled_.count(id) != 0;
     }
 
+    bool stopping() const { return stop_; }
+
+    // Sleep for 'delay' but wake early on cancel/shutdown. Returns false if interrupted.
+    bool wait_before_retry(Id id, retry::Millis delay) {
+        std::unique_lock<std::mutex> lk(m_);
+        return !cv_.wait_for(lk, delay, [&]{ return stop_ || canceled_.count(id) != 0; });
+    }
+
+    enum class Outcome {
+        Ok,
+        Retry,    // transient failure: same URL again after backoff (resume if possible)
+        NextUrl,  // this URL is unusable (4xx, bad URL, local I/O); try the next mirror
+        Canceled,
+        Stopped   // manager shutting down; partial file and journal state kept for resume
+    };
+
+    struct AttemptResult {
+        Outcome outcome = Outcome::NextUrl;
+        std::string error;
+        bool host_fault = false;          // counts against the host's circuit breaker
+        retry::Millis retry_after{0};     // server-requested delay (429/503), 0 if none
+        std::string blob;                 // Ok: content hash; with 'deduped' the bytes come from the store
+        bool deduped = false;
+    };
+
+    // One HTTP attempt for 'url' writing into out_path. 'done' holds bytes already on disk
+    // and is updated as data arrives; a non-zero value is resumed with a Range request.
+    // 'hs' tracks the SHA-256 of the bytes on disk across attempts. With an 'expected' hash,
+    // a stored blob of that hash matching the first megabyte and size ends the transfer early.
+    AttemptResult attempt_once(Id id, const std::string& url, const std::string& out_path, std::uint64_t& done,
+                               detail::HashState& hs, const std::string& expected) {
+        AttemptResult r;
+        bool settled = false; // a callback decided the outcome
+        auto settle = [&](Outcome o, std::string error = {}) {
+            r.outcome = o;
+            r.error = std::move(error);
+            settled = true;
+            return false;
+        };
+        std::ofstream out;
+        std::uint64_t total = 0, start_done = 0;
+        const auto t_start = std::chrono::steady_clock::now();
+        auto t_first_byte = t_start;
+
+        auto on_head = [&](const Head& head) {
+            t_first_byte = std::chrono::steady_clock::now();
+            const int status = head.status;
+            if (status < 200 || status >= 300) {
+                const std::string error = "HTTP " + std::to_string(status);
+                if (status == 416 && done > 0) {
+                    // Range not satisfiable: our partial data is stale; start over from zero
+                    done = 0;
+                    return settle(Outcome::Retry, error);
+                }
+                if (retry::is_retryable_status(status)) {
+                    if (!head.retry_after.empty()) {
+                        retry::parse_retry_after(head.retry_after, r.retry_after, std::time(nullptr), policy_);
+                    }
+                    // Throttling is the host telling us to slow down, not that it is dead
+                    r.host_fault = (status != 429);
+                    if (r.host_fault) host_stats::global().record_failure(url);
+                    return settle(Outcome::Retry, error);
+                }
+                return settle(Outcome::NextUrl, error);
+            }
+
+            // A 200 answer to a Range request means the server ignored it: restart the file
+            const bool resumed = (done > 0 && status == 206);
+            if (!resumed) done = 0;
+            total = head.has_length ? done + head.content_length : 0;
+            set_progress(id, [t = total, d = done](Progress& p){ p.bytes_total = t; p.bytes_done = d; });
+
+            // Start from a fresh inode: the old file may be a link shared with a stored blob
+            if (!resumed) std::remove(out_path.c_str());
+            out.open(out_path, std::ios::binary | (resumed ? std::ios::app : std::ios::trunc));
+            if (!out.is_open()) return settle(Outcome::NextUrl, "Open file failed");
+
+            if (hs.full.size() != done && !hs.rehash(out_path, done)) {
+                // Partial file disappeared or shrank: nothing trustworthy to resume from
+                done = 0;
+                hs.reset();
+                return settle(Outcome::Retry, "Partial file unreadable");
+            }
+            start_done = done;
+            return true;
+        };
+
+        auto on_data = [&](const char* p, std::size_t n) {
+            // Leave the partial file so a later attempt can resume
+            if (is_canceled(id)) return settle(Outcome::Canceled);
+            if (stopping()) return settle(Outcome::Stopped);
+            out.write(p, (std::streamsize)n);
+            if (!out) return settle(Outcome::NextUrl, "Write failed");
+            done += n;
+            if (hs.feed(p, n) && total > 0 && !expected.empty()) {
+                // Same first megabyte and size as a known blob we expect: stop and use it.
+                // Without an expected hash a prefix match proves nothing, so we download in full.
+                std::string known = blob_store::lookup_prefix(hs.prefix_hex, total);
+                if (known == expected) {
+                    r.blob = known;
+                    r.deduped = true;
+                    return settle(Outcome::Ok);
+                }
+            }
+            set_progress(id, [d = done](Progress& p){ p.bytes_done = d; p.status = Status::Running; });
+            return true;
+        };
+
+        std::string error;
+        const Fault fault = transport_.get(Request{url, done, policy_.stall_timeout_s}, on_head, on_data, error);
+        const bool opened = out.is_open();
+        if (opened) out.close();
+        if (settled) return r;
+
+        if (fault == Fault::Transient) {
+            r.outcome = Outcome::Retry;
+            r.error = error;
+            r.host_fault = true;
+            host_stats::global().record_failure(url);
+            return r;
+        }
+        if (fault != Fault::None || !opened) {
+            r.outcome = Outcome::NextUrl;
+            r.error = error.empty() ? "No response" : error;
+            return r;
+        }
+
+        if (total > 0 && done < total) {
+            // Connection closed early: keep what we have and resume
+            r.outcome = Outcome::Retry;
+            r.error = "Truncated";
+            r.host_fault = true;
+            host_stats::global().record_failure(url);
+            return r;
+        }
+
+        {
+            auto t_end = std::chrono::steady_clock::now();
+            double ttfb_ms = std::chrono::duration<double, std::milli>(t_first_byte - t_start).count();
+            double body_s = std::chrono::duration<double>(t_end - t_first_byte).count();
+            host_stats::global().record_success(url, ttfb_ms, done - start_done, body_s);
+        }
+        if (hs.prefix_hex.empty()) hs.prefix_hex = hash::to_hex(hs.prefix.finish());
+        r.blob = hash::to_hex(hs.full.finish());
+        r.outcome = Outcome::Ok;
+        return r;
+    }
+
     void download_one(Id id) {
         Item it;
+        bool resume_partial = false;
         {
             std::lock_guard<std::mutex> lk(m_);
             it = items_[id];
+            resume_partial = resumed_.erase(id) != 0;
         }
 
-        bool ok_any = false;
         std::string last_err;
 
+        // Known content already on disk elsewhere: no network at all
+        if (!it.sha256.empty() && blob_store::has(it.sha256)) {
+            std::string filename = it.title.empty() && !it.urls.empty() ? detail::filename_from_url(it.urls.front()) : it.title;
+            if (filename.empty()) filename = "download.bin";
+            if (blob_store::materialize(it.sha256, detail::join_path(it.target_dir, filename))) {
+                set_progress(id, [](Progress& p){ p.status = Status::Completed; p.message = "Already downloaded"; });
+                return;
+            }
+        }
+
         for (const auto& url : it.urls) {
             if (is_canceled(id)) {
                 set_progress(id, [](Progress& p){ p.status = Status::Canceled; p.message = "Canceled"; });
                 return;
             }
-#if defined(_WIN32)
-            // Crack URL
-            std::wstring urlW = detail::to_wide(url);
-            URL_COMPONENTS uc{};
-            uc.dwStructSize = sizeof(uc);
-            std::wstring scheme(16, L'\0'), host(256, L'\0'), path(2048, L'\0'), extra(2048, L'\0');
-            uc.lpszScheme = &scheme[0]; uc.dwSchemeLength = (DWORD)scheme.size();
-            uc.lpszHostName = &host[0]; uc.dwHostNameLength = (DWORD)host.size();
-            uc.lpszUrlPath  = &path[0]; uc.dwUrlPathLength  = (DWORD)path.size();
-            uc.lpszExtraInfo= &extra[0]; uc.dwExtraInfoLength= (DWORD)extra.size();
-
-            if (!WinHttpCrackUrl(urlW.c_str(), 0, 0, &uc)) {
-                last_err = "CrackUrl failed";
-                continue;
-            }
-            std::wstring hostW(uc.lpszHostName, uc.dwHostNameLength);
-            INTERNET_PORT port = uc.nPort;
-            bool isHttps = (uc.nScheme == INTERNET_SCHEME_HTTPS);
-
-            std::wstring fullPath;
-            fullPath.assign(uc.lpszUrlPath, uc.dwUrlPathLength);
-            if (uc.dwExtraInfoLength) fullPath.append(uc.lpszExtraInfo, uc.dwExtraInfoLength);
-
-            HINTERNET hSession = WinHttpOpen(L"F95ManagerCpp/1.0",
-                                             WINHTTP_ACCESS_TYPE_AUTOMATIC_PROXY,
-                                             WINHTTP_NO_PROXY_NAME,
-                                             WINHTTP_NO_PROXY_BYPASS, 0);
-            if (!hSession) { last_err = "Open session failed"; continue; }
-
-            HINTERNET hConnect = WinHttpConnect(hSession, hostW.c_str(), port, 0);
-            if (!hConnect) { WinHttpCloseHandle(hSession); last_err = "Connect failed"; continue; }
-
-            HINTERNET hRequest = WinHttpOpenRequest(hConnect, L"GET", fullPath.c_str(),
-                                                    nullptr, WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES,
-                                                    isHttps ? WINHTTP_FLAG_SECURE : 0);
-            if (!hRequest) {
-                WinHttpCloseHandle(hConnect);
-                WinHttpCloseHandle(hSession);
-                last_err = "OpenRequest failed"; continue;
-            }
-
-            BOOL ok = WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0,
-                                         WINHTTP_NO_REQUEST_DATA, 0, 0, 0);
-            if (!ok) {
-                WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
-                last_err = "SendRequest failed"; continue;
-            }
-
-            ok = WinHttpReceiveResponse(hRequest, nullptr);
-            if (!ok) {
-                WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
-                last_err = "ReceiveResponse failed"; continue;
-            }
-
-            // Content-Length
-            DWORD size = sizeof(DWORD);
-            DWORD header_len = 0;
-            std::uint64_t content_len = 0;
-            WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_LENGTH | WINHTTP_QUERY_FLAG_NUMBER,
-                                WINHTTP_HEADER_NAME_BY_INDEX, &content_len, &size, WINHTTP_NO_HEADER_INDEX);
+            if (stopping()) return;
 
-            set_progress(id, [content_len](Progress& p){ p.bytes_total = content_len; });
-
-            // Prepare file
+            const std::string host = host_stats::host_key(url);
             std::string filename = it.title.empty() ? detail::filename_from_url(url) : it.title;
             if (filename.empty()) filename = "download.bin";
-            std::string out_path = detail::join_path(it.target_dir, filename);
-            std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
-            if (!out.is_open()) {
-                WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
-                last_err = "Open file failed"; continue;
-            }
+            const std::string out_path = detail::join_path(it.target_dir, filename);
+            // Items restored from the journal continue from whatever reached the disk
+            std::uint64_t done = resume_partial ? detail::file_size(out_path) : 0;
+            detail::HashState hs;
+
+            for (int attempt = 0; attempt < policy_.max_attempts; ++attempt) {
+                if (!retry::breaker().allow(host)) {
+                    last_err = "Host unavailable: " + host;
+                    break;
+                }
 
-            std::uint64_t done = 0;
-            for (;;) {
-                if (is_canceled(id)) {
-                    out.close();
-                    // best-effort: leave partial file
-                    set_progress(id, [](Progress& p){ p.status = Status::Canceled; p.message = "Canceled"; });
-                    WinHttpCloseHandle(hRequest); WinHttpCloseHandle(hConnect); WinHttpCloseHandle(hSession);
+                AttemptResult r = attempt_once(id, url, out_path, done, hs, it.sha256);
+                if (r.outcome == Outcome::Ok) {
+                    retry::breaker().on_success(host);
+                    if (!it.sha256.empty() && r.blob != it.sha256) {
+                        // Wrong bytes from this mirror; discard them and try the next one
+                        std::remove(out_path.c_str());
+                        resume_partial = false;
+                        last_err = "Checksum mismatch";
+                        break;
+                    }
+                    if (r.deduped) {
+                        if (!blob_store::materialize(r.blob, out_path)) {
+                            // No file holding it could be copied; fall back to a full download
+                            done = 0;
+                            hs.reset();
+                            continue;
+                        }
+                        set_progress(id, [](Progress& p){ p.status = Status::Completed; p.message = "Already downloaded"; });
+                        return;
+                    }
+                    blob_store::adopt(out_path, r.blob, hs.prefix_hex, done);
+                    set_progress(id, [](Progress& p){ p.status = Status::Completed; p.message = "Completed"; });
+                    return;
+                }
+                if (r.outcome == Outcome::Canceled || r.outcome == Outcome::Stopped) {
+                    // No verdict on the host; do not leave a half-open probe claimed forever
+                    retry::breaker().release(host);
+                    if (r.outcome == Outcome::Canceled) {
+                        set_progress(id, [](Progress& p){ p.status = Status::Canceled; p.message = "Canceled"; });
+                    }
                     return;
                 }
-                DWORD avail = 0;
-                if (!WinHttpQueryDataAvailable(hRequest, &avail)) break;
-                if (avail == 0) break;
-                std::string chunk;
-                chunk.resize(avail);
-                DWORD read = 0;
-                if (!WinHttpReadData(hRequest, &chunk[0], avail, &read)) break;
-                chunk.resize(read);
-                out.write(chunk.data(), (std::streamsize)chunk.size());
-                done += chunk.size();
-                set_progress(id, [done](Progress& p){ p.bytes_done = done; p.status = Status::Running; });
-            }
-            out.close();
-
-            WinHttpCloseHandle(hRequest);
-            WinHttpCloseHandle(hConnect);
-            WinHttpCloseHandle(hSession);
 
-            set_progress(id, [](Progress& p){ p.status = Status::Completed; p.message = "Completed"; });
-            ok_any = true;
-            break; // success
-#else
-            (void)id;
-            (void)url;
-#endif
+                last_err = r.error;
+                // Any HTTP answer (404, 429, ...) proves the host is alive; only transport faults count
+                if (r.host_fault) retry::breaker().on_failure(host);
+                else retry::breaker().on_success(host);
+                if (r.outcome == Outcome::NextUrl) break;
+                if (attempt + 1 >= policy_.max_attempts) break;
+
+                retry::Millis delay = (std::max)(r.retry_after, retry::backoff_delay(attempt, policy_));
+                set_progress(id, [&](Progress& p){
+                    p.status = Status::Running;
+                    p.message = "Retrying (" + std::to_string(attempt + 2) + "/" + std::to_string(policy_.max_attempts) +
+                                ") in " + std::to_string(delay.count() / 1000) + "s: " + r.error;
+                });
+                if (!wait_before_retry(id, delay)) {
+                    if (is_canceled(id)) set_progress(id, [](Progress& p){ p.status = Status::Canceled; p.message = "Canceled"; });
+                    return;
+                }
+            }
         }
 
-        if (!ok_any) {
-            set_progress(id, [last_err](Progress& p){ p.status = Status::Failed; p.message = last_err; });
-        }
+        set_progress(id, [last_err](Progress& p){ p.status = Status::Failed; p.message = last_err; });
     }
 
 private:
@@ -285,6 +689,10 @@ private:
     std::map<Id, Item> items_;
     std::map<Id, Progress> progresses_;
     std::set<Id> canceled_;
+    std::set<Id> resumed_;
+    Transport transport_;
+    retry::Policy policy_;
+    journal::Journal<Item, Progress, Status> journal_;
 };
 
 // Global singleton-like manager accessor
@@ -297,6 +705,8 @@ inline Manager& global() {
 inline Manager::Id enqueue(const Item& item) { return global().enqueue(item); }
 inline bool cancel(Manager::Id id) { return global().cancel(id); }
 inline Progress query(Manager::Id id) { return global().query(id); }
+inline std::size_t open_journal(const std::string& path) { return global().open_journal(path); }
+inline std::vector<std::pair<Manager::Id, Item>> list() { return global().list(); }
 
 } // namespace downloads
 } // namespace app
@@ -8,6 +8,7 @@
 #include "helpers.hpp"
 #include "../../parser/parser.hpp"
 #include "../../logger.hpp"
+#include "../cache_tier.hpp"
 
 namespace app {
 namespace fetch {
@@ -31,15 +32,38 @@ inline std::string get_body(const std::string& url, int& out_status, const Heade
     return {};
 }
 
+namespace detail {
+inline cache::Loader body_loader(const std::string& url, const Headers& headers) {
+    return [url, headers]() -> cache::Value {
+        int status = 0;
+        std::string body = get_body(url, status, headers);
+        if (status < 200 || status >= 300 || body.empty()) return nullptr;
+        return std::make_shared<const std::string>(std::move(body));
+    };
+}
+} // namespace detail
+
+// GET through the two-tier cache. Concurrent calls for the same URL share one request;
+// resolves to nullptr on failure. Images pass ns = cache::kNsCover, thread pages
+// cache::kNsThread; a stale page is returned at once and refreshed in the background.
+inline std::shared_future<cache::Value> get_cached(const std::string& url, const Headers& headers = {},
+                                                   cache::Options opt = {}) {
+    return cache::get_or_load(url, detail::body_loader(url, headers), opt);
+}
+
+// Blocking get_cached for worker threads: the request runs on the calling thread.
+inline cache::Value get_cached_sync(const std::string& url, const Headers& headers = {}, cache::Options opt = {}) {
+    return cache::get_or_load_sync(url, detail::body_loader(url, headers), opt);
+}
+
 // Fetch a thread page and parse it into GameInfo
 inline parser::GameInfo fetch_and_parse_thread(const std::string& url, const Headers& headers = {}) {
-    int status = 0;
-    std::string html = get_body(url, status, headers);
-    if (status < 200 || status >= 300 || html.empty()) {
+    cache::Value html = get_cached_sync(url, headers, cache::Options{true, true, cache::kNsThread});
+    if (!html) {
         logger::error("Failed to fetch thread: " + url);
         return parser::GameInfo{};
     }
-    return parser::parse_thread(html);
+    return parser::parse_thread(*html);
 }
 
 } // namespace fetch
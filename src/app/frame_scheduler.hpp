@@ -0,0 +1,107 @@
+#pragma once
+// Purpose: Decide when the GUI loop renders a frame, so an idle window costs no CPU or GPU.
+// A frame is due when input arrived (plus a few settle frames, since ImGui reacts to
+// input one frame late), while something animates, until a hover delay started by the
+// last input has run out, or when a background task posted a result; otherwise only
+// after the idle timeout. Frames are never closer together than 1 / max_fps.
+// Platform-neutral: the caller supplies the clock and the wait primitive.
+
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+
+namespace app {
+namespace frame_scheduler {
+
+struct Policy {
+    double max_fps = 60.0;     // <= 0: no cap beyond the swap chain's
+    double idle_timeout = 1.0; // seconds between frames when nothing happens
+    int input_frames = 3;      // frames rendered after each input event
+};
+
+class Scheduler {
+public:
+    explicit Scheduler(Policy p = {}) : policy_(p) {}
+
+    void set_policy(Policy p) { policy_ = p; }
+    const Policy& policy() const { return policy_; }
+
+    // Called by the platform layer for real input only (mouse, keyboard, size, focus);
+    // timers, paints and wake-ups must not keep the loop busy
+    void on_input(double now) {
+        settle_ = (std::max)(settle_, policy_.input_frames);
+        last_input_ = now;
+    }
+
+    // Set after building a frame: something on screen changes without input
+    // (pending uploads, text editing, active widgets)
+    void set_animating(bool on) { animating_ = on; }
+
+    // Called by views while building a frame that draws something time-driven (a moving
+    // progress line). Only covers the frame being built; reset by begin_frame.
+    void report_animation() { reported_ = true; }
+
+    // Called while building a frame when a hover or tooltip reacts 'delay' seconds after
+    // the pointer stops: keep rendering until a frame starts that long after the last input.
+    void hold_after_input(double delay) { hold_until_ = (std::max)(hold_until_, last_input_ + delay); }
+
+    // Any thread: a background result is ready to show. Wakes the loop if it is waiting.
+    void request_redraw() {
+        redraw_.store(true, std::memory_order_release);
+        std::function<void()> w;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            w = waker_;
+        }
+        if (w) w();
+    }
+
+    // Platform hook that interrupts the loop's wait (e.g. signals an event it waits on)
+    void set_waker(std::function<void()> w) {
+        std::lock_guard<std::mutex> lk(m_);
+        waker_ = std::move(w);
+    }
+
+    // Seconds until the next frame is due; 0 means render now
+    double wait_time(double now) const {
+        const bool active = settle_ > 0 || animating_ || reported_ || last_ < hold_until_ ||
+                            redraw_.load(std::memory_order_acquire);
+        const double min_interval = policy_.max_fps > 0.0 ? 1.0 / policy_.max_fps : 0.0;
+        const double due = last_ + (active ? min_interval : (std::max)(policy_.idle_timeout, min_interval));
+        return first_ ? 0.0 : (std::max)(0.0, due - now);
+    }
+
+    bool due(double now) const { return wait_time(now) <= 0.0; }
+
+    // Called when a frame starts. Redraw requests arriving after this get their own frame.
+    void begin_frame(double now) {
+        first_ = false;
+        last_ = now;
+        redraw_.store(false, std::memory_order_release);
+        reported_ = false;
+        hold_until_ = 0.0;
+        if (settle_ > 0) --settle_;
+    }
+
+private:
+    Policy policy_;
+    double last_ = 0.0;
+    bool first_ = true;
+    int settle_ = 0;
+    bool animating_ = false;
+    bool reported_ = false;
+    double last_input_ = 0.0;
+    double hold_until_ = 0.0;
+    std::atomic<bool> redraw_{false};
+    std::mutex m_; // guards waker_
+    std::function<void()> waker_;
+};
+
+inline Scheduler& scheduler() {
+    static Scheduler s;
+    return s;
+}
+
+} // namespace frame_scheduler
+} // namespace app
@@ -0,0 +1,178 @@
+#pragma once
+// Hover gallery for cards (header-only): screenshot N is shown over the cover while the
+// pointer is on cover segment N.
+// When the pointer lands on a card, its screenshots are fetched and decoded on worker
+// threads, nearest to the hovered segment first, so scrubbing finds its neighbours
+// ready. Each card gets at most kCardBudget bytes of decoded frames; moving to another
+// card drops the previous card's queued work. Finished frames are uploaded to a
+// dedicated atlas (cover_atlas.hpp) at most kMaxUploadsPerFrame per frame, and a frame
+// that is not there yet simply keeps the cover on screen: scrubbing never waits.
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+#include "covers.hpp"
+#include "frame_scheduler.hpp"
+
+namespace app {
+namespace gallery {
+
+using covers::Sprite;
+using covers::PageOps;
+
+// Frames are decoded at twice the card width (the full-size source, see
+// parser::attachments::source_for) and drawn into the cover area.
+inline constexpr int kFrameWidth = covers::kThumbWidth * 2;
+inline constexpr int kFrameHeight = kFrameWidth * 9 / 16;
+inline constexpr std::uint64_t kFrameBytes = (std::uint64_t)kFrameWidth * kFrameHeight * 4;
+inline constexpr std::uint64_t kCardBudget = 8ull * 1024 * 1024; // decoded frames per hovered card
+inline constexpr int kWorkers = 2;
+inline constexpr int kMaxUploadsPerFrame = 1;
+inline constexpr std::uint64_t kAtlasBudget = (std::uint64_t)covers::kAtlasPageSize * covers::kAtlasPageSize * 4;
+
+// set_renderer(), hover(), frame(), pump() and clear() are UI-thread only.
+class Gallery {
+public:
+    Gallery() {
+        // An evicted frame of the hovered card is requested again when it is next needed
+        atlas_.set_on_evict([this](const std::string& url){
+            std::lock_guard<std::mutex> lk(m_);
+            requested_.erase(url);
+        });
+    }
+
+    void set_renderer(PageOps ops) { atlas_.set_ops(std::move(ops)); }
+
+    // The pointer is over a card with 'screens', on segment 'index'. Call every frame
+    // while it stays there: switches the prefetch set to this card and reorders its
+    // pending decodes around 'index'.
+    void hover(const std::vector<std::string>& screens, int index) {
+        if (screens.empty()) return;
+        index = std::clamp(index, 0, (int)screens.size() - 1);
+        std::lock_guard<std::mutex> lk(m_);
+        if (screens != card_) {
+            card_ = screens;
+            requested_.clear();
+            jobs_.clear();
+            ready_.clear();
+            ++generation_;
+        }
+        index_ = index;
+        // Nearest first: index, index+1, index-1, index+2, ... within the card budget
+        const std::size_t max_frames = (std::max)(std::uint64_t(1), kCardBudget / kFrameBytes);
+        for (int d = 0; requested_.size() < max_frames && d < (int)screens.size(); ++d) {
+            for (int i : {index + d, index - d}) {
+                if (i < 0 || i >= (int)screens.size() || requested_.size() >= max_frames) continue;
+                const std::string& url = screens[(std::size_t)i];
+                if (atlas_.contains(url) || !requested_.insert(url).second) continue;
+                jobs_.push_back(Job{url, i});
+            }
+        }
+        if (!jobs_.empty() && workers_ < kWorkers) {
+            ++workers_;
+            app::runtime::schedule([this]{ work(); });
+        }
+    }
+
+    // Atlas placement of a frame; empty until it is decoded and uploaded.
+    Sprite frame(const std::string& url) { return atlas_.find(url); }
+
+    // Upload finished frames. Call once per frame before any card is drawn.
+    void pump(int max_uploads = kMaxUploadsPerFrame) {
+        atlas_.begin_frame();
+        for (int n = 0; n < max_uploads; ++n) {
+            Done done;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (ready_.empty()) return;
+                done = std::move(ready_.front());
+                ready_.pop_front();
+            }
+            if (done.image.rgba.empty()) {
+                --n; // failed decodes cost no upload
+                continue;
+            }
+            atlas_.insert(done.url, done.image.pixels());
+        }
+    }
+
+    // Finished frames are waiting for pump()
+    bool has_ready() {
+        std::lock_guard<std::mutex> lk(m_);
+        return !ready_.empty();
+    }
+
+    // Destroy the atlas pages (before the renderer goes away). Work in flight is dropped.
+    void clear() {
+        atlas_.clear();
+        std::lock_guard<std::mutex> lk(m_);
+        card_.clear();
+        requested_.clear();
+        jobs_.clear();
+        ready_.clear();
+        ++generation_;
+    }
+
+private:
+    struct Job {
+        std::string url;
+        int index = 0;
+    };
+    struct Done {
+        std::string url;
+        covers::Image image;
+    };
+
+    void work() {
+        for (;;) {
+            std::string url;
+            std::uint64_t gen = 0;
+            {
+                std::lock_guard<std::mutex> lk(m_);
+                if (jobs_.empty()) {
+                    --workers_;
+                    return;
+                }
+                // Closest to the segment under the pointer right now
+                auto best = std::min_element(jobs_.begin(), jobs_.end(), [this](const Job& a, const Job& b){
+                    return std::abs(a.index - index_) < std::abs(b.index - index_);
+                });
+                url = std::move(best->url);
+                jobs_.erase(best);
+                gen = generation_;
+            }
+            covers::Image full, frame;
+            if (covers::load_image(url, kFrameWidth, full)) frame = covers::make_thumbnail(full, kFrameWidth, kFrameHeight);
+            std::lock_guard<std::mutex> lk(m_);
+            if (gen == generation_) {
+                ready_.push_back(Done{std::move(url), std::move(frame)});
+                frame_scheduler::scheduler().request_redraw();
+            }
+        }
+    }
+
+    covers::Atlas atlas_{covers::kAtlasPageSize, kAtlasBudget}; // UI thread only
+
+    std::mutex m_; // guards everything below
+    std::vector<std::string> card_;            // screens of the hovered card
+    std::unordered_set<std::string> requested_; // queued, decoding or done for card_
+    std::vector<Job> jobs_;
+    std::deque<Done> ready_;
+    int index_ = 0;
+    int workers_ = 0;
+    std::uint64_t generation_ = 0;
+};
+
+inline Gallery& gallery() {
+    static Gallery g;
+    return g;
+}
+
+} // namespace gallery
+} // namespace app
@@ -0,0 +1,229 @@
+#pragma once
+// Per-host download statistics used to rank mirrors before a download starts.
+// Each host keeps attempt/success counters, EWMA of time-to-first-byte and sustained
+// throughput, plus a short ring of recent throughput samples for percentiles.
+// Hosts are keyed by their canonical Hosting domain when known, else by the URL's domain.
+// Persisted as JSON next to config.json (host_stats.json).
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+
+#if __has_include(<nlohmann/json.hpp>)
+#include <nlohmann/json.hpp>
+#else
+#include "../../vendor/nlohmann/json.hpp"
+#endif
+
+#include "../parser/parser.hpp"
+#include "../parser/game_info/hosting.hpp"
+
+namespace app {
+namespace host_stats {
+
+inline constexpr double kEwmaAlpha = 0.3;
+inline constexpr std::size_t kRecentSamples = 16;
+// Reference transfer used to turn TTFB + throughput into one expected duration.
+inline constexpr double kReferenceBytes = 256.0 * 1024.0 * 1024.0;
+// Throughput assumed for hosts we have never measured (so new mirrors still get tried).
+inline constexpr double kPriorBytesPerSec = 2.0 * 1024.0 * 1024.0;
+inline constexpr double kPriorTtfbMs = 800.0;
+
+struct Stats {
+    std::uint64_t attempts = 0;
+    std::uint64_t successes = 0;
+    double ewma_ttfb_ms = 0.0;
+    double ewma_bps = 0.0;
+    std::vector<double> recent_bps; // ring buffer, at most kRecentSamples
+    std::size_t recent_pos = 0;     // next write slot once the ring is full
+};
+
+// Canonical host key: "mega.nz", "gofile.io", or the lowercased domain without "www." and port.
+inline std::string host_key(const std::string& url) {
+    namespace gi = ::parser::game_info;
+    gi::Hosting h;
+    if (gi::try_from_url(url, h)) return gi::to_domain(h);
+    std::string dom = gi::lower(gi::extract_domain(url));
+    auto colon = dom.find(':');
+    if (colon != std::string::npos) dom.resize(colon);
+    if (dom.rfind("www.", 0) == 0) dom.erase(0, 4);
+    return dom;
+}
+
+// p in [0,1]; returns 0 when no samples are recorded
+inline double percentile(const Stats& s, double p) {
+    if (s.recent_bps.empty()) return 0.0;
+    std::vector<double> v = s.recent_bps;
+    std::sort(v.begin(), v.end());
+    p = std::min(1.0, std::max(0.0, p));
+    std::size_t idx = static_cast<std::size_t>(p * (double)(v.size() - 1) + 0.5);
+    return v[idx];
+}
+
+// Smoothed success rate (Laplace), so one failure on a fresh host does not bury it forever.
+inline double success_rate(const Stats& s) {
+    return ((double)s.successes + 1.0) / ((double)s.attempts + 2.0);
+}
+
+// Higher is better: probability of success divided by expected time for a reference transfer.
+// Throughput uses the lower of EWMA and median so a single lucky burst does not dominate.
+inline double score(const Stats& s) {
+    double bps = kPriorBytesPerSec;
+    double ttfb = kPriorTtfbMs;
+    if (!s.recent_bps.empty()) {
+        bps = std::min(s.ewma_bps, percentile(s, 0.5));
+        ttfb = s.ewma_ttfb_ms;
+    }
+    if (bps < 1.0) bps = 1.0;
+    double seconds = ttfb / 1000.0 + kReferenceBytes / bps;
+    return success_rate(s) / seconds;
+}
+
+class Registry {
+public:
+    void record_success(const std::string& url, double ttfb_ms, std::uint64_t bytes, double seconds) {
+        std::lock_guard<std::mutex> lk(m_);
+        Stats& s = hosts_[host_key(url)];
+        s.attempts++;
+        s.successes++;
+        s.ewma_ttfb_ms = (s.successes == 1) ? ttfb_ms : ewma(s.ewma_ttfb_ms, ttfb_ms);
+        // Tiny transfers say nothing about sustained throughput
+        if (bytes >= 256 * 1024 && seconds > 0.0) {
+            double bps = (double)bytes / seconds;
+            s.ewma_bps = s.recent_bps.empty() ? bps : ewma(s.ewma_bps, bps);
+            if (s.recent_bps.size() < kRecentSamples) {
+                s.recent_bps.push_back(bps);
+            } else {
+                s.recent_bps[s.recent_pos] = bps;
+                s.recent_pos = (s.recent_pos + 1) % kRecentSamples;
+            }
+        }
+        dirty_ = true;
+    }
+
+    void record_failure(const std::string& url) {
+        std::lock_guard<std::mutex> lk(m_);
+        hosts_[host_key(url)].attempts++;
+        dirty_ = true;
+    }
+
+    Stats get(const std::string& host) const {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = hosts_.find(host);
+        return it == hosts_.end() ? Stats{} : it->second;
+    }
+
+    double score_for_url(const std::string& url) const {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = hosts_.find(host_key(url));
+        return score(it == hosts_.end() ? Stats{} : it->second);
+    }
+
+    // Stable sort so equally scored mirrors keep the order from the thread page.
+    template <typename T, typename UrlOf>
+    void rank(std::vector<T>& items, UrlOf url_of) const {
+        if (items.size() < 2) return;
+        std::vector<std::pair<double, T>> scored;
+        scored.reserve(items.size());
+        for (auto& it : items) scored.emplace_back(score_for_url(url_of(it)), std::move(it));
+        std::stable_sort(scored.begin(), scored.end(), [](const auto& a, const auto& b){ return a.first > b.first; });
+        for (std::size_t i = 0; i < items.size(); ++i) items[i] = std::move(scored[i].second);
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::in);
+        if (!in.is_open()) return false;
+        try {
+            nlohmann::json j;
+            in >> j;
+            if (!j.is_object()) return false;
+            std::lock_guard<std::mutex> lk(m_);
+            hosts_.clear();
+            for (auto it = j.begin(); it != j.end(); ++it) {
+                const auto& v = it.value();
+                Stats s;
+                if (v.contains("attempts")) v.at("attempts").get_to(s.attempts);
+                if (v.contains("successes")) v.at("successes").get_to(s.successes);
+                if (v.contains("ewma_ttfb_ms")) v.at("ewma_ttfb_ms").get_to(s.ewma_ttfb_ms);
+                if (v.contains("ewma_bps")) v.at("ewma_bps").get_to(s.ewma_bps);
+                if (v.contains("recent_bps")) v.at("recent_bps").get_to(s.recent_bps);
+                if (s.recent_bps.size() > kRecentSamples) s.recent_bps.resize(kRecentSamples);
+                s.recent_pos = s.recent_bps.size() % kRecentSamples;
+                hosts_[it.key()] = std::move(s);
+            }
+            dirty_ = false;
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+    // Writes only when something changed since the last load/save.
+    bool save(const std::string& path) {
+        nlohmann::json j = nlohmann::json::object();
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (!dirty_) return true;
+            for (const auto& kv : hosts_) {
+                const Stats& s = kv.second;
+                // Store the ring oldest-first so reload keeps eviction order
+                std::vector<double> ordered;
+                ordered.reserve(s.recent_bps.size());
+                for (std::size_t i = 0; i < s.recent_bps.size(); ++i) {
+                    ordered.push_back(s.recent_bps[(s.recent_pos + i) % s.recent_bps.size()]);
+                }
+                j[kv.first] = nlohmann::json{
+                    {"attempts", s.attempts},
+                    {"successes", s.successes},
+                    {"ewma_ttfb_ms", s.ewma_ttfb_ms},
+                    {"ewma_bps", s.ewma_bps},
+                    {"recent_bps", ordered}
+                };
+            }
+            dirty_ = false;
+        }
+        try {
+            std::ofstream out(path, std::ios::out | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out << j.dump(2);
+            return true;
+        } catch (...) {
+            return false;
+        }
+    }
+
+private:
+    static double ewma(double prev, double sample) {
+        return prev + kEwmaAlpha * (sample - prev);
+    }
+
+    mutable std::mutex m_;
+    std::unordered_map<std::string, Stats> hosts_;
+    bool dirty_ = false;
+};
+
+inline Registry& global() {
+    static Registry reg;
+    return reg;
+}
+
+inline std::string default_path() { return "host_stats.json"; }
+
+// Convenience API using the global registry
+inline bool load(const std::string& path = default_path()) { return global().load(path); }
+inline bool save(const std::string& path = default_path()) { return global().save(path); }
+
+inline void rank_urls(std::vector<std::string>& urls) {
+    global().rank(urls, [](const std::string& u) -> const std::string& { return u; });
+}
+
+inline void rank_links(std::vector<::parser::LinkInfo>& links) {
+    global().rank(links, [](const ::parser::LinkInfo& l) -> const std::string& { return l.url; });
+}
+
+} // namespace host_stats
+} // namespace app
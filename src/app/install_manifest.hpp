@@ -0,0 +1,335 @@
+#pragma once
+// Install manifests and changed-files-only updates (header-only).
+// At install time every file of a game folder is recorded with size, mtime and SHA-256
+// in <install>/.f95_manifest.json. An update takes a staged tree (the new version,
+// extracted to a temp folder) and only moves over files that are new or changed,
+// deletes files the previous version installed but the new one no longer ships, and
+// never touches save folders or files the manifest does not know about. Without a
+// recorded manifest an update only adds and overwrites; it deletes nothing.
+// Unchanged files are recognized by size + mtime without hashing; a hash is only
+// computed when sizes match but timestamps differ (e.g. a repacked archive).
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <fstream>
+#include <cstdint>
+#include <cctype>
+#include <system_error>
+#include <filesystem>
+
+#if __has_include(<nlohmann/json.hpp>)
+#include <nlohmann/json.hpp>
+#else
+#include "../../vendor/nlohmann/json.hpp"
+#endif
+
+#include "hash.hpp"
+
+namespace app {
+namespace install {
+
+inline constexpr const char* kManifestName = ".f95_manifest.json";
+
+struct FileEntry {
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0; // file_time_type ticks of the installed file
+    std::string sha256;
+};
+
+// Relative generic path ("game/images/a.png") -> entry
+using Manifest = std::map<std::string, FileEntry>;
+
+struct UpdateOptions {
+    // Folder names (any depth, case-insensitive) that hold player data and are never modified
+    std::vector<std::string> keep_dirs{"save", "saves", "savegame", "savegames", "savedata"};
+};
+
+struct UpdateResult {
+    bool ok = false;
+    std::size_t written = 0;
+    std::size_t removed = 0;
+    std::size_t unchanged = 0;
+    std::uint64_t bytes_written = 0;
+    std::string error;
+};
+
+namespace detail {
+namespace sfs = std::filesystem;
+
+inline sfs::path u8path(const std::string& s) {
+    return sfs::path(std::u8string(s.begin(), s.end()));
+}
+
+inline std::string rel_key(const sfs::path& p) {
+    auto u = p.generic_u8string();
+    return std::string(u.begin(), u.end());
+}
+
+inline std::int64_t mtime_of(const sfs::path& p) {
+    std::error_code ec;
+    auto t = sfs::last_write_time(p, ec);
+    return ec ? 0 : (std::int64_t)t.time_since_epoch().count();
+}
+
+inline std::string lower(std::string s) {
+    for (auto& c : s) c = (char)std::tolower((unsigned char)c);
+    return s;
+}
+
+inline bool in_kept_dir(const std::string& rel, const UpdateOptions& opt) {
+    std::size_t b = 0;
+    for (;;) {
+        std::size_t e = rel.find('/', b);
+        if (e == std::string::npos) return false; // last component is the file itself
+        std::string comp = lower(rel.substr(b, e - b));
+        for (const auto& k : opt.keep_dirs) if (comp == lower(k)) return true;
+        b = e + 1;
+    }
+}
+
+// Regular files under root as relative keys (manifest file excluded)
+inline std::vector<std::string> list_files(const sfs::path& root) {
+    std::vector<std::string> out;
+    std::error_code ec;
+    sfs::recursive_directory_iterator it(root, sfs::directory_options::skip_permission_denied, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        std::string key = rel_key(sfs::relative(it->path(), root, ec));
+        if (ec || key.empty() || key == kManifestName) { ec.clear(); continue; }
+        out.push_back(std::move(key));
+    }
+    return out;
+}
+
+// Place 'from' at 'to' replacing any existing file. The staged tree is disposable,
+// so a rename is tried first; across volumes fall back to copy (keeping the mtime).
+inline bool place_file(const sfs::path& from, const sfs::path& to) {
+    std::error_code ec;
+    sfs::create_directories(to.parent_path(), ec);
+    ec.clear();
+    sfs::rename(from, to, ec);
+    if (!ec) return true;
+
+    ec.clear();
+    sfs::path tmp = to;
+    tmp += ".f95tmp";
+    sfs::copy_file(from, tmp, sfs::copy_options::overwrite_existing, ec);
+    if (ec) return false;
+    auto t = sfs::last_write_time(from, ec);
+    if (!ec) sfs::last_write_time(tmp, t, ec);
+    ec.clear();
+    sfs::rename(tmp, to, ec);
+    if (ec) {
+        sfs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+// Remove now-empty parent directories of 'rel' up to (not including) root
+inline void prune_empty_dirs(const sfs::path& root, const std::string& rel) {
+    std::error_code ec;
+    sfs::path dir = (root / u8path(rel)).parent_path();
+    while (!dir.empty() && dir != root && sfs::is_empty(dir, ec) && !ec) {
+        if (!sfs::remove(dir, ec)) break;
+        dir = dir.parent_path();
+    }
+}
+} // namespace detail
+
+inline bool load_manifest(const std::string& install_dir, Manifest& out) {
+    std::ifstream in(detail::u8path(install_dir) / kManifestName, std::ios::in);
+    if (!in.is_open()) return false;
+    try {
+        nlohmann::json j;
+        in >> j;
+        if (!j.is_object() || !j.contains("files") || !j["files"].is_object()) return false;
+        out.clear();
+        for (auto it = j["files"].begin(); it != j["files"].end(); ++it) {
+            const auto& v = it.value();
+            FileEntry e;
+            if (v.contains("size")) v.at("size").get_to(e.size);
+            if (v.contains("mtime")) v.at("mtime").get_to(e.mtime);
+            if (v.contains("sha256")) v.at("sha256").get_to(e.sha256);
+            out[it.key()] = std::move(e);
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+inline bool save_manifest(const std::string& install_dir, const Manifest& m) {
+    nlohmann::json files = nlohmann::json::object();
+    for (const auto& kv : m) {
+        files[kv.first] = nlohmann::json{
+            {"size", kv.second.size},
+            {"mtime", kv.second.mtime},
+            {"sha256", kv.second.sha256}
+        };
+    }
+    nlohmann::json j{{"version", 1}, {"files", files}};
+    const auto dir = detail::u8path(install_dir);
+    auto tmp = dir / (std::string(kManifestName) + ".tmp");
+    try {
+        {
+            std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out << j.dump();
+            if (!out) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, dir / kManifestName, ec);
+        return !ec;
+    } catch (...) {
+        return false;
+    }
+}
+
+// Record every file currently under install_dir. Entries of 'previous' whose size and
+// mtime still match are reused without rehashing.
+inline Manifest build_manifest(const std::string& install_dir, const Manifest& previous = {}) {
+    Manifest m;
+    const auto root = detail::u8path(install_dir);
+    for (const auto& rel : detail::list_files(root)) {
+        const auto p = root / detail::u8path(rel);
+        std::error_code ec;
+        FileEntry e;
+        e.size = (std::uint64_t)std::filesystem::file_size(p, ec);
+        if (ec) continue;
+        e.mtime = detail::mtime_of(p);
+        auto prev = previous.find(rel);
+        if (prev != previous.end() && prev->second.size == e.size && prev->second.mtime == e.mtime &&
+            !prev->second.sha256.empty()) {
+            e.sha256 = prev->second.sha256;
+        } else {
+            auto u = p.u8string();
+            e.sha256 = hash::sha256_file_hex(std::string(u.begin(), u.end()));
+        }
+        m[rel] = std::move(e);
+    }
+    return m;
+}
+
+// Write the manifest for a freshly installed game folder.
+inline bool record_install(const std::string& install_dir) {
+    return save_manifest(install_dir, build_manifest(install_dir));
+}
+
+// Update install_dir in place from staged_dir (the new version's extracted tree).
+// Files moved out of staged_dir are consumed; the caller removes staged_dir afterwards.
+inline UpdateResult apply_update(const std::string& staged_dir, const std::string& install_dir,
+                                 const UpdateOptions& opt = {}) {
+    namespace sfs = std::filesystem;
+    UpdateResult res;
+    const auto staged = detail::u8path(staged_dir);
+    const auto root = detail::u8path(install_dir);
+    std::error_code ec;
+    if (!sfs::is_directory(staged, ec)) { res.error = "Staged folder not found"; return res; }
+
+    Manifest old;
+    const bool recorded = load_manifest(install_dir, old);
+    if (!recorded) {
+        // Installed before manifests existed: nothing is known to belong to the game, so
+        // only index the installed counterparts of staged files (to skip unchanged ones)
+        // and never delete. Saves, configs and mods outside the new tree stay untracked.
+        for (const auto& rel : detail::list_files(staged)) {
+            if (detail::in_kept_dir(rel, opt)) continue;
+            const auto dst = root / detail::u8path(rel);
+            FileEntry e;
+            e.size = (std::uint64_t)sfs::file_size(dst, ec);
+            if (ec) { ec.clear(); continue; }
+            e.mtime = detail::mtime_of(dst);
+            auto u = dst.u8string();
+            e.sha256 = hash::sha256_file_hex(std::string(u.begin(), u.end()));
+            old[rel] = std::move(e);
+        }
+    }
+
+    Manifest next;
+    std::set<std::string> shipped;
+    for (const auto& rel : detail::list_files(staged)) {
+        shipped.insert(rel);
+        if (detail::in_kept_dir(rel, opt)) {
+            auto prev = old.find(rel);
+            if (prev != old.end()) next[rel] = prev->second;
+            continue;
+        }
+
+        const auto src = staged / detail::u8path(rel);
+        const auto dst = root / detail::u8path(rel);
+        const std::uint64_t size = (std::uint64_t)sfs::file_size(src, ec);
+        if (ec) { ec.clear(); continue; }
+        const std::int64_t mtime = detail::mtime_of(src);
+
+        auto prev = old.find(rel);
+        bool same = false;
+        std::string src_hash;
+        if (prev != old.end() && prev->second.size == size) {
+            // The installed copy must still be what the manifest says (not edited or deleted)
+            const std::uint64_t dsize = (std::uint64_t)sfs::file_size(dst, ec);
+            const bool intact = !ec && dsize == prev->second.size && detail::mtime_of(dst) == prev->second.mtime;
+            ec.clear();
+            if (intact) {
+                if (prev->second.mtime == mtime) {
+                    same = true;
+                } else {
+                    auto u = src.u8string();
+                    src_hash = hash::sha256_file_hex(std::string(u.begin(), u.end()));
+                    same = !src_hash.empty() && src_hash == prev->second.sha256;
+                }
+            }
+        }
+        if (same) {
+            next[rel] = prev->second;
+            ++res.unchanged;
+            continue;
+        }
+
+        if (src_hash.empty()) {
+            auto u = src.u8string();
+            src_hash = hash::sha256_file_hex(std::string(u.begin(), u.end()));
+        }
+        if (!detail::place_file(src, dst)) {
+            res.error = "Failed to write " + rel;
+            // Keep what is known so far; files not yet visited keep their old entries
+            for (const auto& kv : old) if (!next.count(kv.first)) next[kv.first] = kv.second;
+            save_manifest(install_dir, next);
+            return res;
+        }
+        FileEntry e;
+        e.size = size;
+        e.mtime = detail::mtime_of(dst);
+        e.sha256 = src_hash;
+        next[rel] = std::move(e);
+        ++res.written;
+        res.bytes_written += size;
+    }
+
+    // Files the previous version installed but the new one does not ship. Only a recorded
+    // manifest says what the game installed; without one nothing is removed.
+    if (recorded) {
+        for (const auto& kv : old) {
+            const std::string& rel = kv.first;
+            if (shipped.count(rel)) continue;
+            if (detail::in_kept_dir(rel, opt)) { next[rel] = kv.second; continue; }
+            if (sfs::remove(root / detail::u8path(rel), ec)) {
+                ++res.removed;
+                detail::prune_empty_dirs(root, rel);
+            }
+            ec.clear();
+        }
+    }
+
+    if (!save_manifest(install_dir, next)) {
+        res.error = "Failed to save manifest";
+        return res;
+    }
+    res.ok = true;
+    return res;
+}
+
+} // namespace install
+} // namespace app
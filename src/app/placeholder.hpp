@@ -0,0 +1,171 @@
+#pragma once
+// Cover placeholders (header-only): a 4x3 DCT colour hash in the style of BlurHash.
+// Computed from the card thumbnail when it is generated and kept in the thumbnail store's
+// placeholder index, apart from the pixels, so a card can paint a blurred impression of
+// its cover as soon as it is drawn, even while the thumbnail is still being fetched.
+// 37 bytes per cover.
+//
+// Encoding: byte 0 = quantized maximum AC magnitude, bytes 1..3 = DC (average colour,
+// sRGB), then the 11 AC components as 3 bytes each (sign-symmetric around 128, scaled by
+// the maximum). Components are computed in linear light.
+
+#include <array>
+#include <span>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace app {
+namespace placeholder {
+
+inline constexpr int kCompX = 4;
+inline constexpr int kCompY = 3;
+inline constexpr std::size_t kBytes = 1 + 3 * kCompX * kCompY;
+
+// Corner colours of a kGridX x kGridY cell grid, for drawing as gradient quads
+inline constexpr int kGridX = 8;
+inline constexpr int kGridY = 4;
+
+struct Hash {
+    std::array<std::uint8_t, kBytes> bytes{};
+    bool valid = false;
+
+    explicit operator bool() const { return valid; }
+};
+
+// Decoded placeholder: (kGridX + 1) * (kGridY + 1) colours, row-major, packed as
+// 0xAABBGGRR (the ImGui IM_COL32 layout).
+struct Grid {
+    std::array<std::uint32_t, (kGridX + 1) * (kGridY + 1)> colors{};
+
+    std::uint32_t at(int x, int y) const { return colors[(std::size_t)y * (kGridX + 1) + x]; }
+};
+
+namespace detail {
+inline constexpr float kPi = 3.14159265358979f;
+
+inline float to_linear(std::uint8_t c) {
+    static const auto table = []{
+        std::array<float, 256> t{};
+        for (int i = 0; i < 256; ++i) {
+            const float v = (float)i / 255.0f;
+            t[(std::size_t)i] = v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table[c];
+}
+
+inline std::uint8_t to_srgb(float v) {
+    v = std::clamp(v, 0.0f, 1.0f);
+    const float s = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+    return (std::uint8_t)std::lround(s * 255.0f);
+}
+
+inline std::uint8_t quantize_ac(float v, float max_ac) {
+    return (std::uint8_t)std::clamp((long)std::lround(v / max_ac * 127.0f) + 128, 0L, 255L);
+}
+inline float unquantize_ac(std::uint8_t q, float max_ac) { return ((float)q - 128.0f) / 127.0f * max_ac; }
+} // namespace detail
+
+// Hash of an RGBA8 image (rows of 'stride' bytes). Invalid for an empty image.
+inline Hash encode(const std::uint8_t* rgba, int w, int h, std::size_t stride) {
+    Hash out;
+    if (!rgba || w <= 0 || h <= 0) return out;
+    float comp[kCompY][kCompX][3] = {};
+    std::array<float, kCompX> bx{};
+    for (int y = 0; y < h; ++y) {
+        float by[kCompY];
+        for (int j = 0; j < kCompY; ++j) by[j] = std::cos(detail::kPi * (float)j * ((float)y + 0.5f) / (float)h);
+        const std::uint8_t* row = rgba + (std::size_t)y * stride;
+        for (int x = 0; x < w; ++x) {
+            for (int i = 0; i < kCompX; ++i) bx[(std::size_t)i] = std::cos(detail::kPi * (float)i * ((float)x + 0.5f) / (float)w);
+            const float r = detail::to_linear(row[x * 4 + 0]);
+            const float g = detail::to_linear(row[x * 4 + 1]);
+            const float b = detail::to_linear(row[x * 4 + 2]);
+            for (int j = 0; j < kCompY; ++j) {
+                for (int i = 0; i < kCompX; ++i) {
+                    const float basis = by[j] * bx[(std::size_t)i];
+                    comp[j][i][0] += basis * r;
+                    comp[j][i][1] += basis * g;
+                    comp[j][i][2] += basis * b;
+                }
+            }
+        }
+    }
+    const float n = (float)w * (float)h;
+    float max_ac = 0.0f;
+    for (int j = 0; j < kCompY; ++j) {
+        for (int i = 0; i < kCompX; ++i) {
+            const float scale = (i == 0 && j == 0) ? 1.0f / n : 2.0f / n;
+            for (int c = 0; c < 3; ++c) {
+                comp[j][i][c] *= scale;
+                if (i || j) max_ac = (std::max)(max_ac, std::fabs(comp[j][i][c]));
+            }
+        }
+    }
+    // Byte 0: max AC in 1/256 steps, rounded up so quantized components never clip
+    const int qmax = std::clamp((int)std::ceil(max_ac * 256.0f) - 1, 0, 255);
+    const float max_q = (float)(qmax + 1) / 256.0f;
+    std::size_t p = 0;
+    out.bytes[p++] = (std::uint8_t)qmax;
+    for (int c = 0; c < 3; ++c) out.bytes[p++] = detail::to_srgb(comp[0][0][c]);
+    for (int j = 0; j < kCompY; ++j) {
+        for (int i = 0; i < kCompX; ++i) {
+            if (!i && !j) continue;
+            for (int c = 0; c < 3; ++c) out.bytes[p++] = detail::quantize_ac(comp[j][i][c], max_q);
+        }
+    }
+    out.valid = true;
+    return out;
+}
+
+// Parse a stored hash; invalid if 'bytes' is not a hash.
+inline Hash from_bytes(std::span<const std::uint8_t> bytes) {
+    Hash h;
+    if (bytes.size() != kBytes) return h;
+    std::copy(bytes.begin(), bytes.end(), h.bytes.begin());
+    h.valid = true;
+    return h;
+}
+
+// Average colour (the DC component), 0xAABBGGRR
+inline std::uint32_t average(const Hash& h) {
+    if (!h) return 0;
+    return 0xFF000000u | ((std::uint32_t)h.bytes[3] << 16) | ((std::uint32_t)h.bytes[2] << 8) | h.bytes[1];
+}
+
+inline Grid decode(const Hash& h) {
+    Grid g;
+    if (!h) return g;
+    const float max_q = (float)(h.bytes[0] + 1) / 256.0f;
+    float comp[kCompY][kCompX][3];
+    std::size_t p = 1;
+    for (int c = 0; c < 3; ++c) comp[0][0][c] = detail::to_linear(h.bytes[p++]);
+    for (int j = 0; j < kCompY; ++j) {
+        for (int i = 0; i < kCompX; ++i) {
+            if (!i && !j) continue;
+            for (int c = 0; c < 3; ++c) comp[j][i][c] = detail::unquantize_ac(h.bytes[p++], max_q);
+        }
+    }
+    for (int gy = 0; gy <= kGridY; ++gy) {
+        for (int gx = 0; gx <= kGridX; ++gx) {
+            const float u = (float)gx / (float)kGridX, v = (float)gy / (float)kGridY;
+            float rgb[3] = {};
+            for (int j = 0; j < kCompY; ++j) {
+                const float by = std::cos(detail::kPi * (float)j * v);
+                for (int i = 0; i < kCompX; ++i) {
+                    const float basis = by * std::cos(detail::kPi * (float)i * u);
+                    for (int c = 0; c < 3; ++c) rgb[c] += basis * comp[j][i][c];
+                }
+            }
+            g.colors[(std::size_t)gy * (kGridX + 1) + gx] = 0xFF000000u | ((std::uint32_t)detail::to_srgb(rgb[2]) << 16) |
+                                                             ((std::uint32_t)detail::to_srgb(rgb[1]) << 8) | detail::to_srgb(rgb[0]);
+        }
+    }
+    return g;
+}
+
+} // namespace placeholder
+} // namespace app
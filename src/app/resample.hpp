@@ -0,0 +1,328 @@
+#pragma once
+// Separable RGBA8 resampler (header-only) used for cover thumbnails.
+// A horizontal pass filters each source row of the crop rectangle into a float row,
+// then a vertical pass filters those rows into the destination. Filters:
+//   Box       area average when shrinking (exact fractional coverage), nearest when growing
+//   Bilinear  triangle filter, widened by the scale factor when shrinking
+//   Lanczos3  windowed sinc, sharper but about 3x the taps of Bilinear
+// Every output sample uses the same padded number of taps, which keeps the SIMD loops
+// branch-free. SSE2 (baseline on x64) and AVX2 (picked at run time) accumulate in the
+// same per-channel order as the scalar path, which stays the reference for both.
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define APP_RESAMPLE_X64 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define APP_RESAMPLE_AVX2
+#  else
+#    define APP_RESAMPLE_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace app {
+namespace resample {
+
+enum class Filter { Box, Bilinear, Lanczos3 };
+enum class Isa { Scalar, Sse2, Avx2 };
+
+struct Rect {
+    int x = 0, y = 0, w = 0, h = 0;
+};
+
+// Widest instruction set usable on this CPU/OS.
+inline Isa best_isa() {
+#if defined(APP_RESAMPLE_X64)
+    static const Isa isa = []{
+#  if defined(_MSC_VER) && !defined(__clang__)
+        int r[4] = {0, 0, 0, 0};
+        __cpuid(r, 1);
+        const bool osxsave = (r[2] & (1 << 27)) != 0;
+        const bool avx_state = osxsave && (_xgetbv(0) & 6) == 6; // OS saves XMM+YMM
+        __cpuidex(r, 7, 0);
+        return avx_state && (r[1] & (1 << 5)) ? Isa::Avx2 : Isa::Sse2;
+#  else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? Isa::Avx2 : Isa::Sse2;
+#  endif
+    }();
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Sse2: return "sse2";
+        case Isa::Avx2: return "avx2";
+        default:        return "scalar";
+    }
+}
+
+namespace detail {
+
+// Contributions along one axis: output i reads source [first[i], first[i] + taps)
+// (absolute coordinates) with weights[i * taps + k]. Unused taps have weight 0.
+struct Taps {
+    int taps = 0;
+    std::vector<int> first;
+    std::vector<float> weights;
+};
+
+inline double sinc(double x) {
+    if (x == 0.0) return 1.0;
+    x *= 3.14159265358979323846;
+    return std::sin(x) / x;
+}
+
+inline double kernel(Filter f, double x) {
+    x = std::fabs(x);
+    switch (f) {
+        case Filter::Bilinear: return x < 1.0 ? 1.0 - x : 0.0;
+        case Filter::Lanczos3: return x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+        default:               return x <= 0.5 ? 1.0 : 0.0;
+    }
+}
+
+inline Taps make_taps(Filter f, int src_offset, int src_len, int dst_len) {
+    std::vector<std::vector<float>> w((std::size_t)dst_len);
+    std::vector<int> lo((std::size_t)dst_len);
+    const double scale = (double)src_len / (double)dst_len;
+    const double fscale = (std::max)(scale, 1.0);
+    const double support = (f == Filter::Lanczos3 ? 3.0 : f == Filter::Bilinear ? 1.0 : 0.5) * fscale;
+    int taps = 1;
+    for (int i = 0; i < dst_len; ++i) {
+        const double center = (i + 0.5) * scale;
+        int s0 = (int)std::floor(center - support), s1 = (int)std::ceil(center + support);
+        s0 = (std::max)(s0, 0);
+        s1 = (std::min)(s1, src_len);
+        if (s1 <= s0) { s0 = (std::min)((int)center, src_len - 1); s1 = s0 + 1; }
+        auto& row = w[(std::size_t)i];
+        double sum = 0.0;
+        for (int s = s0; s < s1; ++s) {
+            double v;
+            if (f == Filter::Box && scale > 1.0) {
+                // Exact overlap of source pixel [s, s+1) with the output footprint
+                const double b = i * scale, e = (i + 1) * scale;
+                v = (std::max)(0.0, (std::min)(e, (double)s + 1) - (std::max)(b, (double)s));
+            } else {
+                v = kernel(f, (s + 0.5 - center) / fscale);
+            }
+            row.push_back((float)v);
+            sum += v;
+        }
+        if (sum == 0.0) { row.assign(row.size(), 0.0f); row[row.size() / 2] = 1.0f; sum = 1.0; }
+        for (auto& v : row) v = (float)(v / sum);
+        // Trim zero weights at both ends so the padded width stays small
+        while (row.size() > 1 && row.back() == 0.0f) row.pop_back();
+        while (row.size() > 1 && row.front() == 0.0f) { row.erase(row.begin()); ++s0; }
+        lo[(std::size_t)i] = s0;
+        taps = (std::max)(taps, (int)row.size());
+    }
+    taps = (std::min)(taps, src_len);
+
+    Taps t;
+    t.taps = taps;
+    t.first.resize((std::size_t)dst_len);
+    t.weights.assign((std::size_t)dst_len * taps, 0.0f);
+    for (int i = 0; i < dst_len; ++i) {
+        const auto& row = w[(std::size_t)i];
+        // Shift the window left if padding would run past the end of the source
+        const int first = (std::min)(lo[(std::size_t)i], src_len - taps);
+        const int skip = lo[(std::size_t)i] - first;
+        t.first[(std::size_t)i] = src_offset + first;
+        for (std::size_t k = 0; k < row.size() && skip + (int)k < taps; ++k) {
+            t.weights[(std::size_t)i * taps + skip + k] = row[k];
+        }
+    }
+    return t;
+}
+
+// ---- horizontal pass: one source row -> dst_w * 4 floats ----
+
+inline void hrow_scalar(const std::uint8_t* src, const Taps& t, int dst_w, float* out) {
+    for (int x = 0; x < dst_w; ++x) {
+        const std::uint8_t* p = src + (std::size_t)t.first[(std::size_t)x] * 4;
+        const float* w = t.weights.data() + (std::size_t)x * t.taps;
+        float a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+        for (int k = 0; k < t.taps; ++k, p += 4) {
+            a0 = a0 + w[k] * (float)p[0];
+            a1 = a1 + w[k] * (float)p[1];
+            a2 = a2 + w[k] * (float)p[2];
+            a3 = a3 + w[k] * (float)p[3];
+        }
+        out[x * 4 + 0] = a0;
+        out[x * 4 + 1] = a1;
+        out[x * 4 + 2] = a2;
+        out[x * 4 + 3] = a3;
+    }
+}
+
+// ---- vertical pass: 'taps' float rows -> one RGBA8 row ----
+
+inline std::uint8_t to_u8(float v) {
+    v = (std::min)((std::max)(v, 0.0f), 255.0f);
+    return (std::uint8_t)(int)(v + 0.5f);
+}
+
+inline void vrow_scalar(const float* const* rows, const float* w, int taps, int n, std::uint8_t* out) {
+    for (int i = 0; i < n; ++i) {
+        float a = 0;
+        for (int k = 0; k < taps; ++k) a = a + w[k] * rows[k][i];
+        out[i] = to_u8(a);
+    }
+}
+
+#if defined(APP_RESAMPLE_X64)
+inline __m128 load_px_sse2(const std::uint8_t* p) {
+    int v;
+    std::memcpy(&v, p, 4);
+    const __m128i z = _mm_setzero_si128();
+    __m128i x = _mm_cvtsi32_si128(v);
+    x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(x, z), z);
+    return _mm_cvtepi32_ps(x);
+}
+
+inline void hrow_sse2(const std::uint8_t* src, const Taps& t, int dst_w, float* out) {
+    for (int x = 0; x < dst_w; ++x) {
+        const std::uint8_t* p = src + (std::size_t)t.first[(std::size_t)x] * 4;
+        const float* w = t.weights.data() + (std::size_t)x * t.taps;
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < t.taps; ++k, p += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), load_px_sse2(p)));
+        }
+        _mm_storeu_ps(out + x * 4, acc);
+    }
+}
+
+// Four floats -> four bytes with the scalar path's clamp-then-round
+inline void store4_sse2(__m128 a, std::uint8_t* out) {
+    a = _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    __m128i i = _mm_cvttps_epi32(_mm_add_ps(a, _mm_set1_ps(0.5f)));
+    i = _mm_packus_epi16(_mm_packs_epi32(i, i), i);
+    const int v = _mm_cvtsi128_si32(i);
+    std::memcpy(out, &v, 4);
+}
+
+// 'i' is the first column to produce (lets the AVX2 path hand over its tail)
+inline void vrow_sse2(const float* const* rows, const float* w, int taps, int n, std::uint8_t* out, int i = 0) {
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_setzero_ps();
+        for (int k = 0; k < taps; ++k) a = _mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(rows[k] + i)));
+        store4_sse2(a, out + i);
+    }
+    for (; i < n; ++i) {
+        float a = 0;
+        for (int k = 0; k < taps; ++k) a = a + w[k] * rows[k][i];
+        out[i] = to_u8(a);
+    }
+}
+
+// Two output pixels per iteration: low lane = pixel x, high lane = pixel x + 1
+APP_RESAMPLE_AVX2 inline void hrow_avx2(const std::uint8_t* src, const Taps& t, int dst_w, float* out) {
+    int x = 0;
+    for (; x + 2 <= dst_w; x += 2) {
+        const std::uint8_t* p0 = src + (std::size_t)t.first[(std::size_t)x] * 4;
+        const std::uint8_t* p1 = src + (std::size_t)t.first[(std::size_t)x + 1] * 4;
+        const float* w0 = t.weights.data() + (std::size_t)x * t.taps;
+        const float* w1 = w0 + t.taps;
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < t.taps; ++k) {
+            int a, b;
+            std::memcpy(&a, p0 + (std::size_t)k * 4, 4);
+            std::memcpy(&b, p1 + (std::size_t)k * 4, 4);
+            const __m128i px = _mm_unpacklo_epi32(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b));
+            const __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(px));
+            const __m256 wv = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(w0[k])), _mm_set1_ps(w1[k]), 1);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(wv, v));
+        }
+        _mm256_storeu_ps(out + x * 4, acc);
+    }
+    for (; x < dst_w; ++x) {
+        const std::uint8_t* p = src + (std::size_t)t.first[(std::size_t)x] * 4;
+        const float* w = t.weights.data() + (std::size_t)x * t.taps;
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < t.taps; ++k, p += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), load_px_sse2(p)));
+        }
+        _mm_storeu_ps(out + x * 4, acc);
+    }
+}
+
+APP_RESAMPLE_AVX2 inline void vrow_avx2(const float* const* rows, const float* w, int taps, int n, std::uint8_t* out) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k) a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_set1_ps(w[k]), _mm256_loadu_ps(rows[k] + i)));
+        store4_sse2(_mm256_castps256_ps128(a), out + i);
+        store4_sse2(_mm256_extractf128_ps(a, 1), out + i + 4);
+    }
+    vrow_sse2(rows, w, taps, n, out, i);
+}
+#endif
+
+} // namespace detail
+
+// Resample the 'crop' rectangle of an RGBA8 image to dst_w x dst_h.
+// Strides are in bytes. Returns false on invalid arguments.
+inline bool rgba8(const std::uint8_t* src, int src_w, int src_h, std::size_t src_stride, Rect crop,
+                  std::uint8_t* dst, int dst_w, int dst_h, std::size_t dst_stride,
+                  Filter filter = Filter::Box, Isa isa = best_isa()) {
+    if (!src || !dst || dst_w <= 0 || dst_h <= 0 || crop.w <= 0 || crop.h <= 0) return false;
+    if (crop.x < 0 || crop.y < 0 || crop.x + crop.w > src_w || crop.y + crop.h > src_h) return false;
+#if !defined(APP_RESAMPLE_X64)
+    isa = Isa::Scalar;
+#else
+    if (isa == Isa::Avx2 && best_isa() != Isa::Avx2) isa = Isa::Sse2;
+#endif
+
+    const detail::Taps tx = detail::make_taps(filter, crop.x, crop.w, dst_w);
+    const detail::Taps ty = detail::make_taps(filter, 0, crop.h, dst_h);
+    const std::size_t row_floats = (std::size_t)dst_w * 4;
+
+    // Horizontal pass over only the source rows some output row actually reads
+    int y_lo = crop.h, y_hi = 0;
+    for (int y = 0; y < dst_h; ++y) {
+        y_lo = (std::min)(y_lo, ty.first[(std::size_t)y]);
+        y_hi = (std::max)(y_hi, ty.first[(std::size_t)y] + ty.taps);
+    }
+    std::vector<float> rows((std::size_t)(y_hi - y_lo) * row_floats);
+    for (int y = y_lo; y < y_hi; ++y) {
+        const std::uint8_t* s = src + (std::size_t)(crop.y + y) * src_stride;
+        float* d = rows.data() + (std::size_t)(y - y_lo) * row_floats;
+        switch (isa) {
+#if defined(APP_RESAMPLE_X64)
+            case Isa::Avx2: detail::hrow_avx2(s, tx, dst_w, d); break;
+            case Isa::Sse2: detail::hrow_sse2(s, tx, dst_w, d); break;
+#endif
+            default:        detail::hrow_scalar(s, tx, dst_w, d); break;
+        }
+    }
+
+    std::vector<const float*> taps((std::size_t)ty.taps);
+    for (int y = 0; y < dst_h; ++y) {
+        for (int k = 0; k < ty.taps; ++k) {
+            taps[(std::size_t)k] = rows.data() + (std::size_t)(ty.first[(std::size_t)y] + k - y_lo) * row_floats;
+        }
+        const float* w = ty.weights.data() + (std::size_t)y * ty.taps;
+        std::uint8_t* d = dst + (std::size_t)y * dst_stride;
+        switch (isa) {
+#if defined(APP_RESAMPLE_X64)
+            case Isa::Avx2: detail::vrow_avx2(taps.data(), w, ty.taps, (int)row_floats, d); break;
+            case Isa::Sse2: detail::vrow_sse2(taps.data(), w, ty.taps, (int)row_floats, d); break;
+#endif
+            default:        detail::vrow_scalar(taps.data(), w, ty.taps, (int)row_floats, d); break;
+        }
+    }
+    return true;
+}
+
+} // namespace resample
+} // namespace app
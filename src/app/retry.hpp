@@ -0,0 +1,200 @@
+#pragma once
+// Retry helpers for network transfers (header-only):
+// - jittered exponential backoff ("full jitter")
+// - Retry-After parsing (delta-seconds or IMF-fixdate)
+// - per-host circuit breaker so a dead host stops consuming download slots
+// Transport specifics (WinHTTP) stay in downloads.hpp; this file is platform-neutral.
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <ctime>
+#include <cctype>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+
+namespace app {
+namespace retry {
+
+using Clock = std::chrono::steady_clock;
+using Millis = std::chrono::milliseconds;
+
+struct Policy {
+    int max_attempts = 5;            // per URL, including the first try
+    Millis base_delay{500};
+    Millis max_delay{30000};
+    Millis max_retry_after{300000};  // cap server-requested waits at 5 minutes
+    std::uint32_t stall_timeout_s = 30; // reconnect when no bytes arrive for this long
+};
+
+inline const Policy& default_policy() {
+    static Policy p;
+    return p;
+}
+
+// Statuses worth retrying on the same URL (others move on to the next mirror).
+inline bool is_retryable_status(int status) {
+    switch (status) {
+        case 408: case 425: case 429:
+        case 500: case 502: case 503: case 504:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Delay before retry number 'attempt' (0-based): uniform in [0, min(max, base * 2^attempt)].
+inline Millis backoff_delay(int attempt, const Policy& p = default_policy()) {
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+    if (attempt < 0) attempt = 0;
+    if (attempt > 20) attempt = 20;
+    std::int64_t cap = (std::min)(p.max_delay.count(), p.base_delay.count() << attempt);
+    if (cap <= 0) return Millis{0};
+    std::uniform_int_distribution<std::int64_t> dist(0, cap);
+    return Millis{dist(rng)};
+}
+
+namespace detail {
+inline int month_index(const std::string& m) {
+    static const char* names[] = {"jan","feb","mar","apr","may","jun","jul","aug","sep","oct","nov","dec"};
+    std::string l;
+    for (char c : m) l.push_back((char)std::tolower((unsigned char)c));
+    for (int i = 0; i < 12; ++i) if (l == names[i]) return i;
+    return -1;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (avoids timegm/_mkgmtime differences)
+inline std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (std::int64_t)doe - 719468;
+}
+} // namespace detail
+
+// Parse a Retry-After header value into a wait duration.
+// Accepts "120" or "Wed, 21 Oct 2015 07:28:00 GMT". Returns false if unparseable.
+inline bool parse_retry_after(const std::string& value, Millis& out,
+                              std::time_t now = std::time(nullptr),
+                              const Policy& p = default_policy()) {
+    std::size_t b = 0, e = value.size();
+    while (b < e && std::isspace((unsigned char)value[b])) ++b;
+    while (e > b && std::isspace((unsigned char)value[e - 1])) --e;
+    if (b == e) return false;
+    std::string v = value.substr(b, e - b);
+
+    if (std::all_of(v.begin(), v.end(), [](unsigned char c){ return std::isdigit(c) != 0; })) {
+        if (v.size() > 9) { out = p.max_retry_after; return true; }
+        out = (std::min)(Millis{std::stoll(v) * 1000}, p.max_retry_after);
+        return true;
+    }
+
+    // IMF-fixdate: "Sun, 06 Nov 1994 08:49:37 GMT"
+    char wday[4] = {0}, mon[4] = {0}, tz[4] = {0};
+    int day = 0, year = 0, hh = 0, mm = 0, ss = 0;
+    if (std::sscanf(v.c_str(), "%3[A-Za-z], %d %3s %d %d:%d:%d %3s", wday, &day, mon, &year, &hh, &mm, &ss, tz) != 8) {
+        return false;
+    }
+    int mi = detail::month_index(mon);
+    if (mi < 0 || day < 1 || day > 31) return false;
+    std::int64_t when = detail::days_from_civil(year, (unsigned)(mi + 1), (unsigned)day) * 86400
+                      + hh * 3600 + mm * 60 + ss;
+    std::int64_t delta = when - (std::int64_t)now;
+    if (delta < 0) delta = 0;
+    out = (std::min)(Millis{delta * 1000}, p.max_retry_after);
+    return true;
+}
+
+// Per-host circuit breaker.
+// Closed: requests flow. After 'failure_threshold' consecutive failures the host opens for
+// 'open_duration' (doubling on each re-open, capped). When the window elapses a single
+// probe is allowed (half-open); success closes the circuit, failure re-opens it.
+class CircuitBreaker {
+public:
+    struct Config {
+        int failure_threshold = 3;
+        Millis open_duration{60000};
+        Millis max_open_duration{600000};
+    };
+
+    CircuitBreaker() = default;
+    explicit CircuitBreaker(Config cfg) : cfg_(cfg) {}
+
+    bool allow(const std::string& host, Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = hosts_.find(host);
+        if (it == hosts_.end()) return true;
+        Entry& e = it->second;
+        if (e.state == State::Closed) return true;
+        if (e.state == State::Open && now >= e.open_until) {
+            e.state = State::HalfOpen;
+            e.probe_in_flight = false;
+        }
+        if (e.state == State::HalfOpen && !e.probe_in_flight) {
+            e.probe_in_flight = true;
+            return true;
+        }
+        return false;
+    }
+
+    void on_success(const std::string& host) {
+        std::lock_guard<std::mutex> lk(m_);
+        hosts_.erase(host);
+    }
+
+    void on_failure(const std::string& host, Clock::time_point now = Clock::now()) {
+        std::lock_guard<std::mutex> lk(m_);
+        Entry& e = hosts_[host];
+        e.consecutive_failures++;
+        if (e.state == State::HalfOpen || e.consecutive_failures >= cfg_.failure_threshold) {
+            Millis d = cfg_.open_duration;
+            for (int i = 0; i < e.reopen_count && d < cfg_.max_open_duration; ++i) d *= 2;
+            d = (std::min)(d, cfg_.max_open_duration);
+            e.state = State::Open;
+            e.open_until = now + d;
+            e.probe_in_flight = false;
+            e.reopen_count++;
+        }
+    }
+
+    // The caller gave up before the attempt reached a verdict (e.g. user cancel).
+    // Frees a half-open probe slot so the next request may probe; no state change otherwise.
+    void release(const std::string& host) {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = hosts_.find(host);
+        if (it != hosts_.end() && it->second.state == State::HalfOpen) it->second.probe_in_flight = false;
+    }
+
+    bool is_open(const std::string& host, Clock::time_point now = Clock::now()) const {
+        std::lock_guard<std::mutex> lk(m_);
+        auto it = hosts_.find(host);
+        return it != hosts_.end() && it->second.state == State::Open && now < it->second.open_until;
+    }
+
+private:
+    enum class State { Closed, Open, HalfOpen };
+    struct Entry {
+        State state = State::Closed;
+        int consecutive_failures = 0;
+        int reopen_count = 0;
+        bool probe_in_flight = false;
+        Clock::time_point open_until{};
+    };
+
+    Config cfg_{};
+    mutable std::mutex m_;
+    std::unordered_map<std::string, Entry> hosts_;
+};
+
+inline CircuitBreaker& breaker() {
+    static CircuitBreaker cb;
+    return cb;
+}
+
+} // namespace retry
+} // namespace app
@@ -4,10 +4,19 @@
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <cerrno>
 
 #if defined(_WIN32)
 #  include <windows.h>
 #  include <shlobj.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/stat.h>
+#  if defined(__linux__)
+#    include <sys/ioctl.h>
+#    include <linux/fs.h>
+#  endif
 #endif
 
 namespace app {
@@ -44,11 +53,72 @@ inline bool ensure_dir(const std::string& path) {
     // best-effort
     return true;
 #else
-    // TODO: non-Windows impl if needed
+    if (path.empty()) return false;
+    for (std::size_t i = 1; i <= path.size(); ++i) {
+        if (i == path.size() || path[i] == '/') {
+            std::string cur = path.substr(0, i);
+            if (::mkdir(cur.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+    }
+    return true;
+#endif
+}
+
+#if !defined(_WIN32)
+// Copy-on-write clone of a whole file (Linux FICLONE: btrfs, XFS, bcachefs...). False if unsupported.
+inline bool reflink_file(const std::string& from, const std::string& to) {
+#if defined(__linux__) && defined(FICLONE)
+    int src = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src < 0) return false;
+    int dst = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dst < 0) { ::close(src); return false; }
+    bool ok = ::ioctl(dst, FICLONE, src) == 0;
+    ::close(src);
+    ::close(dst);
+    if (!ok) ::unlink(to.c_str());
+    return ok;
+#else
+    (void)from; (void)to;
     return false;
 #endif
 }
 
+// In-kernel copy (copy_file_range where available, else read/write), truncating 'to'.
+inline bool copy_file_posix(const std::string& from, const std::string& to) {
+    int src = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (src < 0) return false;
+    int dst = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dst < 0) { ::close(src); return false; }
+    bool ok = true;
+    bool done = false;
+#if defined(__linux__)
+    // copy_file_range keeps the data in the kernel (and lets the filesystem offload it)
+    for (bool any = false;;) {
+        ssize_t n = ::copy_file_range(src, nullptr, dst, nullptr, 1 << 30, 0);
+        if (n > 0) { any = true; continue; }
+        if (n == 0) done = true;
+        else if (any || (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EOPNOTSUPP)) ok = false;
+        break;
+    }
+#endif
+    char buf[64 * 1024];
+    while (ok && !done) {
+        ssize_t n = ::read(src, buf, sizeof(buf));
+        if (n == 0) break;
+        if (n < 0) { ok = false; break; }
+        for (ssize_t off = 0; off < n && ok; ) {
+            ssize_t w = ::write(dst, buf + off, (size_t)(n - off));
+            if (w <= 0) ok = false;
+            else off += w;
+        }
+    }
+    ::close(src);
+    ::close(dst);
+    if (!ok) ::unlink(to.c_str());
+    return ok;
+}
+#endif
+
 inline bool copy_file(const std::string& from, const std::string& to) {
 #if defined(_WIN32)
     auto to_wide = [](const std::string& s) {
@@ -62,7 +132,7 @@ inline bool copy_file(const std::string& from, const std::string& to) {
     std::wstring wt = to_wide(to);
     return CopyFileW(wf.c_str(), wt.c_str(), FALSE) != 0;
 #else
-    return false;
+    return reflink_file(from, to) || copy_file_posix(from, to);
 #endif
 }
 
@@ -8,6 +8,7 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
 
 // single-header json in vendor/nlohmann/json.hpp (added in CMake include dirs)
 #if __has_include(<nlohmann/json.hpp>)
@@ -31,6 +32,10 @@ struct Config {
     // Behavior
     bool cache_on_download = true; // settings-cache-on-download
     bool log_to_file = false;      // settings-log-to-file
+    std::uint64_t cache_max_mb = 2048; // settings-cache-max-mb (0 = unlimited)
+    std::uint64_t cover_atlas_mb = 64; // settings-cover-atlas-mb (GPU memory for card covers)
+    int ui_max_fps = 60;               // frame rate cap while the UI is active (0 = vsync only)
+    int ui_idle_timeout_ms = 1000;     // redraw interval when nothing changes
 
     // Launch
     std::string custom_launch;     // settings-custom-launch ({{path}} placeholder)
@@ -71,6 +76,10 @@ inline void to_json(nlohmann::json& j, const Config& c) {
         {"language", c.language},
         {"cache_on_download", c.cache_on_download},
         {"log_to_file", c.log_to_file},
+        {"cache_max_mb", c.cache_max_mb},
+        {"cover_atlas_mb", c.cover_atlas_mb},
+        {"ui_max_fps", c.ui_max_fps},
+        {"ui_idle_timeout_ms", c.ui_idle_timeout_ms},
         {"custom_launch", c.custom_launch},
         {"startup_tags", c.startup_tags},
         {"startup_exclude_tags", c.startup_exclude_tags},
@@ -93,6 +102,10 @@ inline void from_json(const nlohmann::json& j, Config& c) {
 
     if (j.contains("cache_on_download")) j.at("cache_on_download").get_to(tmp.cache_on_download);
     if (j.contains("log_to_file")) j.at("log_to_file").get_to(tmp.log_to_file);
+    if (j.contains("cache_max_mb")) j.at("cache_max_mb").get_to(tmp.cache_max_mb);
+    if (j.contains("cover_atlas_mb")) j.at("cover_atlas_mb").get_to(tmp.cover_atlas_mb);
+    if (j.contains("ui_max_fps")) j.at("ui_max_fps").get_to(tmp.ui_max_fps);
+    if (j.contains("ui_idle_timeout_ms")) j.at("ui_idle_timeout_ms").get_to(tmp.ui_idle_timeout_ms);
 
     if (j.contains("custom_launch")) j.at("custom_launch").get_to(tmp.custom_launch);
 
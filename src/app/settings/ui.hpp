@@ -115,6 +115,14 @@ inline bool render(Config& cfg) {
             if (ImGui::Checkbox("Cache on download", &cache_on)) { s.staged.cache_on_download = cache_on; s.dirty = true; }
             bool log_file = s.staged.log_to_file;
             if (ImGui::Checkbox("Log to file", &log_file)) { s.staged.log_to_file = log_file; s.dirty = true; }
+            int cache_mb = (int)s.staged.cache_max_mb;
+            if (ImGui::InputInt("Cache size limit (MB, 0 = unlimited)", &cache_mb, 256, 1024)) {
+                s.staged.cache_max_mb = (std::uint64_t)(cache_mb < 0 ? 0 : cache_mb); s.dirty = true;
+            }
+            int atlas_mb = (int)s.staged.cover_atlas_mb;
+            if (ImGui::InputInt("Cover texture memory (MB)", &atlas_mb, 16, 64)) {
+                s.staged.cover_atlas_mb = (std::uint64_t)(atlas_mb < 16 ? 16 : atlas_mb); s.dirty = true;
+            }
         }
 
         ImGui::Separator();
@@ -0,0 +1,174 @@
+#pragma once
+// Persistent card-size thumbnail store (header-only).
+// Decoded, resized covers are kept as raw RGBA8 in a dedicated pack store
+// (cache_pack.hpp) under <cache_dir>/thumbs, keyed by the first 128 bits of the
+// SHA-256 of the image URL. The pack segments are memory-mapped, so a stored
+// thumbnail goes from the mapping straight to a texture upload: no decode, no resize,
+// no copy on the CPU side.
+//
+// Record value: [u32 magic][u16 width][u16 height][u32 format] pixels
+// Records with an unknown magic/format or a short payload are treated as missing.
+//
+// Cover placeholder hashes (placeholder.hpp) live in a second, tiny pack under
+// <cache_dir>/thumbs/placeholders with the same keys. Reading one maps only that pack,
+// never pixels, and it outlives the thumbnail: a card whose thumbnail was trimmed (or is
+// still being fetched) paints its blurred placeholder right away.
+//
+// The store has its own byte budget (set_budget, carved out of the cache limit by the
+// caller). Going over it compacts the pack and then drops the oldest segments;
+// thumbnails are recreated from the cached images when needed again. The placeholder
+// pack is not budgeted (under 100 bytes per cover).
+
+#include <string>
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+
+#include "cache_pack.hpp"
+#include "runtime.hpp"
+#include "hash.hpp"
+
+namespace app {
+namespace thumbs {
+
+inline constexpr std::uint32_t kThumbMagic = 0x424D5454u; // "TTMB"
+inline constexpr std::size_t kMaxPlaceholderBytes = 1024;
+
+enum class Format : std::uint32_t {
+    Rgba8 = 0, // 4 bytes per pixel, rows top to bottom, no padding
+};
+
+struct Header {
+    std::uint32_t magic = kThumbMagic;
+    std::uint16_t width = 0;
+    std::uint16_t height = 0;
+    std::uint32_t format = (std::uint32_t)Format::Rgba8;
+};
+static_assert(sizeof(Header) == 12, "thumbnail header layout");
+
+// Stored thumbnail; 'rgba' points into the mapped segment and stays valid while 'hold' lives.
+struct Thumb {
+    int width = 0;
+    int height = 0;
+    const std::uint8_t* rgba = nullptr;
+    cache::pack::View hold;
+
+    explicit operator bool() const { return rgba != nullptr; }
+};
+
+inline constexpr std::uint64_t kSegmentBytes = 32ull * 1024 * 1024; // eviction granularity
+inline constexpr double kTrimLowWatermark = 0.9;
+inline constexpr std::uint64_t kPlaceholderSegmentBytes = 1024 * 1024;
+
+inline cache::pack::Store& store() {
+    static cache::pack::Store s(kSegmentBytes);
+    return s;
+}
+
+inline cache::pack::Store& placeholders() {
+    static cache::pack::Store s(kPlaceholderSegmentBytes);
+    return s;
+}
+
+inline std::atomic<std::uint64_t>& budget_mut() {
+    static std::atomic<std::uint64_t> bytes{0}; // 0 = unlimited
+    return bytes;
+}
+
+inline std::atomic<bool>& trimming_mut() {
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+// Compact, then drop the oldest segments until under the low watermark.
+inline void trim_now() {
+    const std::uint64_t budget = budget_mut().load();
+    placeholders().compact();
+    store().compact();
+    if (budget != 0 && store().disk_bytes() > budget) {
+        store().evict_oldest((std::uint64_t)((double)budget * kTrimLowWatermark));
+    }
+}
+
+// Trim in the background if over budget (at most one pass at a time).
+inline void maybe_trim() {
+    const std::uint64_t budget = budget_mut().load();
+    if (budget == 0 || store().disk_bytes() <= budget) return;
+    if (trimming_mut().exchange(true)) return;
+    app::runtime::schedule([]{
+        trim_now();
+        trimming_mut() = false;
+    });
+}
+
+// Byte budget for the store on disk (0 = unlimited). Takes effect immediately.
+inline void set_budget(std::uint64_t bytes) {
+    budget_mut() = bytes;
+    if (store().is_open()) maybe_trim();
+}
+
+// Open the store in 'dir' and compact (and trim) it in the background.
+inline bool init(const std::string& dir) {
+    if (dir.empty() || !store().open(dir)) return false;
+    placeholders().open(dir + "/placeholders");
+    trimming_mut() = true;
+    app::runtime::schedule([]{
+        trim_now();
+        trimming_mut() = false;
+    });
+    return true;
+}
+
+inline std::string key_for(const std::string& url) {
+    hash::Sha256 h;
+    h.update(url);
+    const hash::Digest d = h.finish();
+    return hash::to_hex(d.data(), 16);
+}
+
+inline bool put(const std::string& url, int width, int height, std::span<const std::uint8_t> rgba) {
+    if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) return false;
+    if (rgba.size() != (std::size_t)width * height * 4 || !store().is_open()) return false;
+    Header hdr;
+    hdr.width = (std::uint16_t)width;
+    hdr.height = (std::uint16_t)height;
+    std::vector<std::uint8_t> rec(sizeof(Header) + rgba.size());
+    std::memcpy(rec.data(), &hdr, sizeof(Header));
+    std::memcpy(rec.data() + sizeof(Header), rgba.data(), rgba.size());
+    if (!store().put(key_for(url), rec)) return false;
+    maybe_trim();
+    return true;
+}
+
+inline Thumb get(const std::string& url) {
+    if (!store().is_open()) return {};
+    cache::pack::View v = store().get(key_for(url));
+    if (!v || v.data.size() < sizeof(Header)) return {};
+    Header hdr;
+    std::memcpy(&hdr, v.data.data(), sizeof(Header));
+    if (hdr.magic != kThumbMagic || hdr.format != (std::uint32_t)Format::Rgba8) return {};
+    if (hdr.width == 0 || hdr.height == 0) return {};
+    if (v.data.size() - sizeof(Header) != (std::size_t)hdr.width * hdr.height * 4) return {};
+    Thumb t;
+    t.width = hdr.width;
+    t.height = hdr.height;
+    t.rgba = v.data.data() + sizeof(Header);
+    t.hold = std::move(v);
+    return t;
+}
+
+// Placeholder hash for 'url' (bytes as written; empty if none). Independent of the pixels.
+inline bool put_placeholder(const std::string& url, std::span<const std::uint8_t> hash) {
+    if (hash.empty() || hash.size() > kMaxPlaceholderBytes || !placeholders().is_open()) return false;
+    return placeholders().put(key_for(url), hash);
+}
+
+inline cache::pack::View get_placeholder(const std::string& url) {
+    if (!placeholders().is_open()) return {};
+    return placeholders().get(key_for(url));
+}
+
+} // namespace thumbs
+} // namespace app
@@ -0,0 +1,260 @@
+// Headless frame-time benchmark for the views layer. Dear ImGui runs without a platform
+// or renderer backend: every frame is built and its draw data discarded. Each view is
+// driven through a scripted session (scrolling down and back up while the pointer sweeps
+// across the window, so hover paths run) over synthetic catalogs of 100, 1k and 10k
+// games. Reported per view: CPU frame time percentiles (NewFrame to Render) and heap
+// allocations per frame (operator new plus ImGui's allocator).
+// Usage: f95_ui_bench [frames]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <new>
+#include <vector>
+#include <string>
+#include <random>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+#include "imgui.h"
+#include "views/cards/render.hpp"
+#include "views/filters/render.hpp"
+#include "views/logs/render.hpp"
+#include "tags/mod.hpp"
+#include "logger.hpp"
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocs{0};
+
+void* imgui_alloc(std::size_t n, void*) {
+    ++g_allocs;
+    return std::malloc(n);
+}
+void imgui_free(void* p, void*) { std::free(p); }
+
+} // namespace
+
+// Count every C++ heap allocation in the process
+void* operator new(std::size_t n) {
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr float kDisplayW = 1600.0f;
+constexpr float kDisplayH = 900.0f;
+constexpr int kWarmupFrames = 30;
+
+struct Result {
+    std::vector<double> ms;
+    std::vector<std::uint64_t> allocs;
+    int vertices = 0;
+};
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    const std::size_t i = (std::size_t)std::min<double>((double)v.size() - 1, p * (double)(v.size() - 1) + 0.5);
+    return v[i];
+}
+
+// 0 -> 1 -> 0 over the session
+float triangle(int frame, int frames) {
+    const float t = (float)(frame % frames) / (float)frames;
+    return t < 0.5f ? t * 2.0f : 2.0f - t * 2.0f;
+}
+
+void null_render() {
+#if defined(IMGUI_HAS_TEXTURES)
+    // Accept texture requests without a GPU
+    if (ImDrawData* dd = ImGui::GetDrawData(); dd && dd->Textures) {
+        for (ImTextureData* t : *dd->Textures) {
+            if (t->Status == ImTextureStatus_WantCreate || t->Status == ImTextureStatus_WantUpdates) {
+                t->SetTexID((ImTextureID)1);
+                t->SetStatus(ImTextureStatus_OK);
+            } else if (t->Status == ImTextureStatus_WantDestroy) {
+                t->SetTexID(ImTextureID_Invalid);
+                t->SetStatus(ImTextureStatus_Destroyed);
+            }
+        }
+    }
+#endif
+}
+
+// Run 'frames' measured frames of 'draw' (called inside NewFrame/Render with the frame index)
+Result run(int frames, const std::function<void(int)>& draw) {
+    ImGuiIO& io = ImGui::GetIO();
+    Result r;
+    for (int f = 0; f < kWarmupFrames + frames; ++f) {
+        io.DisplaySize = ImVec2(kDisplayW, kDisplayH);
+        io.DeltaTime = 1.0f / 60.0f;
+        // Pointer sweeps left to right every 120 frames, bobbing vertically
+        const float mx = (float)(f % 120) / 120.0f * kDisplayW;
+        const float my = kDisplayH * (0.2f + 0.6f * triangle(f, 90));
+        io.AddMousePosEvent(mx, my);
+
+        const std::uint64_t a0 = g_allocs.load();
+        const auto t0 = std::chrono::steady_clock::now();
+        ImGui::NewFrame();
+        draw(f);
+        ImGui::Render();
+        const auto t1 = std::chrono::steady_clock::now();
+        const std::uint64_t a1 = g_allocs.load();
+        null_render();
+        if (f >= kWarmupFrames) {
+            r.ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            r.allocs.push_back(a1 - a0);
+            r.vertices = ImGui::GetDrawData() ? ImGui::GetDrawData()->TotalVtxCount : 0;
+        }
+    }
+    return r;
+}
+
+void report(const char* view, const std::string& size, const Result& r) {
+    double mean_allocs = 0.0;
+    std::uint64_t max_allocs = 0;
+    for (auto a : r.allocs) {
+        mean_allocs += (double)a;
+        max_allocs = (std::max)(max_allocs, a);
+    }
+    if (!r.allocs.empty()) mean_allocs /= (double)r.allocs.size();
+    std::printf("%-8s %8s %8.3f %8.3f %8.3f %8.3f %12.1f %10llu %9d\n", view, size.c_str(),
+                percentile(r.ms, 0.50), percentile(r.ms, 0.95), percentile(r.ms, 0.99),
+                *std::max_element(r.ms.begin(), r.ms.end()), mean_allocs, (unsigned long long)max_allocs, r.vertices);
+}
+
+std::vector<std::string> catalog_tag_names(const tags::Catalog& cat) {
+    std::vector<std::string> names;
+    for (const auto& [id, name] : cat.tags) names.push_back(name);
+    std::sort(names.begin(), names.end());
+    if (names.empty()) {
+        for (int i = 0; i < 150; ++i) names.push_back("tag " + std::to_string(i));
+    }
+    return names;
+}
+
+// Games shaped like parsed threads: wrapped titles, 4-14 tags, a few links. Covers and
+// screenshots are left empty so nothing is fetched; the cover pipeline has its own bench.
+std::vector<parser::GameInfo> synthetic_games(std::size_t n, const std::vector<std::string>& tag_names) {
+    static const char* words[] = {"Summer", "Academy", "Lust", "Dreams", "Secret", "Island", "Night", "Sisters", "Office",
+                                  "Legacy", "Chronicles", "Shadow", "Village", "Hero", "Kingdom", "Lessons"};
+    static const char* engines[] = {"Ren'Py", "Unity", "RPGM", "HTML", "Unreal Engine", "Others"};
+    static const char* hosts[] = {"https://gofile.io/d/", "https://mega.nz/file/", "https://pixeldrain.com/u/", "https://www.mediafire.com/file/"};
+    std::mt19937 rng(42);
+    std::vector<parser::GameInfo> out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& g = out[i];
+        const int nw = 2 + (int)(rng() % 5);
+        g.meta.title = std::string("[") + engines[rng() % 6] + "] ";
+        for (int w = 0; w < nw; ++w) g.meta.title += std::string(words[rng() % 16]) + " ";
+        g.meta.title += "[v0." + std::to_string(rng() % 20) + "] #" + std::to_string(i);
+        g.meta.author = "Studio " + std::to_string(rng() % 500);
+        g.meta.version = "v0." + std::to_string(rng() % 20) + "." + std::to_string(rng() % 10);
+        const int nt = 4 + (int)(rng() % 11);
+        for (int t = 0; t < nt; ++t) g.meta.tags.push_back(tag_names[rng() % tag_names.size()]);
+        const int nl = 1 + (int)(rng() % 4);
+        for (int l = 0; l < nl; ++l) {
+            parser::LinkInfo li;
+            li.url = std::string(hosts[l % 4]) + std::to_string(rng());
+            li.provider = parser::classify_provider(li.url);
+            li.type = "archive";
+            g.links.push_back(li);
+        }
+    }
+    return out;
+}
+
+void begin_fullscreen(const char* name, float x, float w) {
+    ImGui::SetNextWindowPos(ImVec2(x, 0.0f));
+    ImGui::SetNextWindowSize(ImVec2(w, kDisplayH));
+    ImGui::Begin(name, nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? (std::max)(10, std::atoi(argv[1])) : 600;
+
+    IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(imgui_alloc, imgui_free);
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+    io.Fonts->AddFontDefault();
+#if defined(IMGUI_HAS_TEXTURES)
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+#else
+    unsigned char* font_px = nullptr;
+    int font_w = 0, font_h = 0;
+    io.Fonts->GetTexDataAsRGBA32(&font_px, &font_w, &font_h);
+    io.Fonts->SetTexID((ImTextureID)1);
+#endif
+    ImGui::StyleColorsDark();
+
+    tags::Catalog cat;
+    if (!tags::load_from_json("src/tags/tags.json", cat)) tags::load_from_json("../src/tags/tags.json", cat);
+    const auto tag_names = catalog_tag_names(cat);
+    app::settings::Config cfg;
+    for (std::size_t i = 0; i < tag_names.size(); i += 25) cfg.warn_tags.push_back(tag_names[i]);
+    cfg.warn_prefixes = {"Abandoned", "Onhold"};
+
+    std::printf("%d frames per run (+%d warm-up), %gx%g, times in ms\n", frames, kWarmupFrames, kDisplayW, kDisplayH);
+    std::printf("%-8s %8s %8s %8s %8s %8s %12s %10s %9s\n", "view", "size", "p50", "p95", "p99", "max", "allocs/frame", "max allocs", "vertices");
+
+    for (std::size_t n : {std::size_t(100), std::size_t(1000), std::size_t(10000)}) {
+        auto games = synthetic_games(n, tag_names);
+        for (auto& g : games) views::cards::items::ingest(g, tags::index_for(cat));
+        // Cards: scroll the grid top -> bottom -> top over the run
+        Result r = run(frames, [&](int f) {
+            begin_fullscreen("Cards", 0.0f, kDisplayW);
+            ImGui::SetScrollY(ImGui::GetScrollMaxY() * triangle(f, frames));
+            views::cards::draw_cards_grid(games, n, (float)ui_constants::kCardWidth, &cfg, &cat);
+            ImGui::End();
+        });
+        report("cards", std::to_string(n), r);
+    }
+
+    {
+        views::filters::Model model;
+        const views::filters::RenderOptions opts;
+        Result r = run(frames, [&](int f) {
+            begin_fullscreen("Filters", kDisplayW - 360.0f, 360.0f);
+            ImGui::SetScrollY(ImGui::GetScrollMaxY() * triangle(f, frames));
+            views::filters::draw_filters_panel(opts, model, &cat);
+            ImGui::End();
+        });
+        report("filters", "-", r);
+    }
+
+    for (std::size_t n : {std::size_t(100), std::size_t(1000), std::size_t(10000)}) {
+        // Fill the logger's ring buffer (capped by the logger) without echoing to stdout
+        logger::clear();
+        std::ostringstream sink;
+        std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+        for (std::size_t i = 0; i < n; ++i) logger::info("GET https://f95zone.to/threads/" + std::to_string(i) + "/ 200 (" + std::to_string(i * 7 % 900) + " ms)");
+        std::cout.rdbuf(old);
+        std::size_t prev = 0;
+        Result r = run(frames, [&](int f) {
+            begin_fullscreen("Logs", 0.0f, kDisplayW);
+            ImGui::SetNextWindowScroll(ImVec2(0.0f, 1e6f * triangle(f, frames)));
+            views::logs::draw_log_lines(false, prev);
+            ImGui::End();
+        });
+        report("logs", std::to_string(logger::line_count()), r);
+    }
+
+    ImGui::DestroyContext();
+    std::cout.flush();
+    // Worker threads (cover pipeline) may still be parked; skip static destructors
+    std::quick_exit(0);
+}
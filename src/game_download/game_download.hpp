@@ -27,8 +27,9 @@ struct Progress {
 class Downloader {
 public:
     // Start download into target_dir, return true if started successfully.
-    // The first working link will be used by the underlying manager.
-    bool start(const std::vector<DownloadLink>& links, const std::string& target_dir) {
+    // The first working link will be used by the underlying manager. An expected SHA-256
+    // (hex) lets the manager reuse a stored copy and rejects mirrors serving other bytes.
+    bool start(const std::vector<DownloadLink>& links, const std::string& target_dir, const std::string& sha256 = {}) {
         if (links.empty() || target_dir.empty()) {
             return false;
         }
@@ -36,6 +37,7 @@ public:
         app::downloads::Item it;
         it.title = ""; // let filename be inferred from URL by downloads manager
         it.target_dir = target_dir;
+        it.sha256 = app::downloads::parse_sha256(sha256);
         it.urls.reserve(links.size());
         for (const auto& l : links) {
             it.urls.push_back(l.url);
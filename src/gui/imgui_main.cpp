@@ -8,6 +8,9 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 #include "../../vendor/imgui/imgui.h"
 #include "../../vendor/imgui/backends/imgui_impl_win32.h"
@@ -19,10 +22,21 @@
 #include "../app/fetch/fetch.hpp"
 #include "../parser/parser.hpp"
 #include "../app/downloads.hpp"
+#include "../app/host_stats.hpp"
+#include "../app/blob_store.hpp"
+#include "../app/cache.hpp"
+#include "../app/covers.hpp"
+#include "../app/gallery.hpp"
+#include "../app/frame_scheduler.hpp"
+#include "../app/thumb_store.hpp"
+#include "../app/install_manifest.hpp"
+#include "../app/runtime.hpp"
 #include "../tags/mod.hpp"
 #include "../types.hpp"
 #include "../ui_constants.hpp"
 #include "../views/cards/render.hpp"
+#include "../views/filters/option_index.hpp"
+#include "../views/logs/render.hpp"
 #include "../app/about_ui.hpp"
 
 #pragma comment(lib, "d3d11.lib")
@@ -79,6 +93,47 @@ static bool CreateDeviceD3D(HWND hWnd)
     return true;
 }
 
+// Cover atlas page: an empty RGBA texture filled region by region; the SRV is the ImGui texture id
+static app::covers::Texture CreateCoverPage(int size)
+{
+    if (!g_pd3dDevice || size <= 0) return 0;
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = (UINT)size;
+    desc.Height = (UINT)size;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    ID3D11Texture2D* tex = nullptr;
+    if (FAILED(g_pd3dDevice->CreateTexture2D(&desc, nullptr, &tex))) return 0;
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+    ID3D11ShaderResourceView* srv = nullptr;
+    HRESULT hr = g_pd3dDevice->CreateShaderResourceView(tex, &srvDesc, &srv);
+    tex->Release(); // the view keeps the texture alive
+    return SUCCEEDED(hr) ? (app::covers::Texture)srv : 0;
+}
+
+static void UpdateCoverPage(app::covers::Texture page, int x, int y, const app::covers::Pixels& px)
+{
+    if (!page || !g_pd3dDeviceContext) return;
+    ID3D11Resource* res = nullptr;
+    ((ID3D11ShaderResourceView*)page)->GetResource(&res);
+    if (!res) return;
+    D3D11_BOX box = { (UINT)x, (UINT)y, 0, (UINT)(x + px.width), (UINT)(y + px.height), 1 };
+    g_pd3dDeviceContext->UpdateSubresource(res, 0, &box, px.rgba, (UINT)px.width * 4, 0);
+    res->Release();
+}
+
+static void DestroyCoverPage(app::covers::Texture page)
+{
+    if (page) ((ID3D11ShaderResourceView*)page)->Release();
+}
+
 static void CleanupDeviceD3D()
 {
     CleanupRenderTarget();
@@ -95,6 +150,18 @@ static void ResizeSwapChain(UINT width, UINT height)
     CreateRenderTarget();
 }
 
+// Monotonic seconds for the frame scheduler
+static double now_seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Split the cache size limit: a quarter for decoded thumbnails, the rest for the file cache
+static void apply_cache_budgets(const app::settings::Config& cfg) {
+    const std::uint64_t total = cfg.cache_max_mb * 1024ull * 1024ull; // 0 = unlimited
+    app::thumbs::set_budget(total / 4);
+    app::cache::set_budget(total - total / 4);
+}
+
 static std::wstring to_wide(const std::string& s) {
     if (s.empty()) return std::wstring();
     int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0);
@@ -116,6 +183,9 @@ struct AppGuiState {
     std::string cookieHeader;
     parser::GameInfo game;
     bool fetchedOk = false;
+    // Cards shown in the grid; kept across frames, card_items_gen is bumped on every change
+    std::vector<parser::GameInfo> card_items;
+    std::uint64_t card_items_gen = 0;
     std::string fetchStatus;
 
     // Settings UI
@@ -126,6 +196,16 @@ struct AppGuiState {
     std::string downloads_target_dir;
     std::vector<std::pair<app::downloads::Manager::Id, app::downloads::Item>> downloads_list;
     std::string downloads_info;
+    // Install/update of an extracted game folder (runs off the UI thread)
+    struct InstallJob {
+        std::mutex m;
+        bool done = false;
+        std::string info;
+    };
+    std::string install_staged_dir;
+    std::string install_game_dir;
+    std::shared_ptr<InstallJob> install_job;
+    std::string install_info;
     // Tags
     tags::Catalog catalog;
     bool tagsLoaded = false;
@@ -311,25 +391,18 @@ static void render_filters_panel(struct AppGuiState& st) {
         ImGui::NewLine();
 
         if (st.tagsLoaded) {
-            std::vector<std::pair<int,std::string>> tagOptions;
-            tagOptions.reserve(st.catalog.tags.size());
-            for (auto& kv : st.catalog.tags) tagOptions.emplace_back(kv.first, kv.second);
-            std::sort(tagOptions.begin(), tagOptions.end(), [](auto& a, auto& b){ return a.second < b.second; });
+            const auto& tagOptions = views::filters::option_index::tags_for(st.catalog);
 
             std::string ph = l10n(st.bundle, "filters-select-tag-include");
             if (ph.empty()) ph = "Select a tag to filter...";
-            if (ImGui::BeginCombo("##tag_inc", ph.c_str())) {
-                for (auto& opt : tagOptions) {
-                    bool selected = (std::find(st.include_tags.begin(), st.include_tags.end(), opt.first) != st.include_tags.end());
-                    if (ImGui::Selectable(opt.second.c_str(), selected)) {
-                        if (!selected && (int)st.include_tags.size() < ui_constants::kMaxFilterItems) {
-                            st.include_tags.push_back(opt.first);
-                            st.filter_search.clear();
-                        }
-                    }
-                    if (selected) ImGui::SetItemDefaultFocus();
+            int picked = 0;
+            if (views::filters::option_index::combo("##tag_inc", tagOptions,
+                    views::filters::option_index::selection(tagOptions, st.include_tags), picked, ph.c_str())) {
+                if (std::find(st.include_tags.begin(), st.include_tags.end(), picked) == st.include_tags.end() &&
+                    (int)st.include_tags.size() < ui_constants::kMaxFilterItems) {
+                    st.include_tags.push_back(picked);
+                    st.filter_search.clear();
                 }
-                ImGui::EndCombo();
             }
 
             // Render removable chips
@@ -364,25 +437,18 @@ static void render_filters_panel(struct AppGuiState& st) {
         ImGui::SeparatorText(hdr.c_str());
 
         if (st.tagsLoaded) {
-            std::vector<std::pair<int,std::string>> tagOptions;
-            tagOptions.reserve(st.catalog.tags.size());
-            for (auto& kv : st.catalog.tags) tagOptions.emplace_back(kv.first, kv.second);
-            std::sort(tagOptions.begin(), tagOptions.end(), [](auto& a, auto& b){ return a.second < b.second; });
+            const auto& tagOptions = views::filters::option_index::tags_for(st.catalog);
 
             std::string ph = l10n(st.bundle, "filters-select-tag-exclude");
             if (ph.empty()) ph = "Select a tag to exclude...";
-            if (ImGui::BeginCombo("##tag_exc", ph.c_str())) {
-                for (auto& opt : tagOptions) {
-                    bool selected = (std::find(st.exclude_tags.begin(), st.exclude_tags.end(), opt.first) != st.exclude_tags.end());
-                    if (ImGui::Selectable(opt.second.c_str(), selected)) {
-                        if (!selected && (int)st.exclude_tags.size() < ui_constants::kMaxFilterItems) {
-                            st.exclude_tags.push_back(opt.first);
-                            st.filter_search.clear();
-                        }
-                    }
-                    if (selected) ImGui::SetItemDefaultFocus();
+            int picked = 0;
+            if (views::filters::option_index::combo("##tag_exc", tagOptions,
+                    views::filters::option_index::selection(tagOptions, st.exclude_tags), picked, ph.c_str())) {
+                if (std::find(st.exclude_tags.begin(), st.exclude_tags.end(), picked) == st.exclude_tags.end() &&
+                    (int)st.exclude_tags.size() < ui_constants::kMaxFilterItems) {
+                    st.exclude_tags.push_back(picked);
+                    st.filter_search.clear();
                 }
-                ImGui::EndCombo();
             }
 
             // Render removable chips
@@ -411,20 +477,10 @@ static void render_filters_panel(struct AppGuiState& st) {
     ImGui::Separator();
 
     // PREFIXES include/exclude
-    auto build_prefix_options = [&](std::vector<std::pair<int,std::string>>& out) {
-        auto add = [&](const char* cat_name, const std::vector<tags::Group>& gs) {
-            for (const auto& g : gs) {
-                for (const auto& p : g.prefixes) {
-                    out.emplace_back(p.id, std::string(cat_name) + ": " + p.name);
-                }
-            }
-        };
-        out.clear();
-        add("Games", st.catalog.games);
-        add("Comics", st.catalog.comics);
-        add("Animations", st.catalog.animations);
-        add("Assets", st.catalog.assets);
-        std::sort(out.begin(), out.end(), [](auto& a, auto& b){ return a.second < b.second; });
+    const auto& prefOptions = views::filters::option_index::prefixes_for(st.catalog);
+    auto prefix_label = [&](int id) {
+        const std::string* name = prefOptions.label(id);
+        return name ? *name : std::to_string(id);
     };
 
     {
@@ -432,22 +488,15 @@ static void render_filters_panel(struct AppGuiState& st) {
         if (hdr.empty()) hdr = "PREFIXES";
         ImGui::SeparatorText(hdr.c_str());
 
-        std::vector<std::pair<int,std::string>> prefOptions;
-        build_prefix_options(prefOptions);
-
         std::string ph = l10n(st.bundle, "filters-select-prefix-include");
         if (ph.empty()) ph = "Select a prefix to include...";
-        if (ImGui::BeginCombo("##pref_inc", ph.c_str())) {
-            for (auto& opt : prefOptions) {
-                bool selected = (std::find(st.include_prefixes.begin(), st.include_prefixes.end(), opt.first) != st.include_prefixes.end());
-                if (ImGui::Selectable(opt.second.c_str(), selected)) {
-                    if (!selected && (int)st.include_prefixes.size() < ui_constants::kMaxFilterItems) {
-                        st.include_prefixes.push_back(opt.first);
-                    }
-                }
-                if (selected) ImGui::SetItemDefaultFocus();
+        int picked = 0;
+        if (views::filters::option_index::combo("##pref_inc", prefOptions,
+                views::filters::option_index::selection(prefOptions, st.include_prefixes), picked, ph.c_str())) {
+            if (std::find(st.include_prefixes.begin(), st.include_prefixes.end(), picked) == st.include_prefixes.end() &&
+                (int)st.include_prefixes.size() < ui_constants::kMaxFilterItems) {
+                st.include_prefixes.push_back(picked);
             }
-            ImGui::EndCombo();
         }
 
         // Render removable chips
@@ -456,15 +505,7 @@ static void render_filters_panel(struct AppGuiState& st) {
             ImGui::SameLine();
             ImGui::BeginGroup();
             for (size_t i=0;i<st.include_prefixes.size();) {
-                int id = st.include_prefixes[i];
-                // Find name
-                std::string name;
-                {
-                    std::vector<std::pair<int,std::string>> opts; build_prefix_options(opts);
-                    auto it = std::find_if(opts.begin(), opts.end(), [&](auto& p){ return p.first == id; });
-                    name = (it==opts.end()? std::to_string(id) : it->second);
-                }
-                std::string lab = name + " ×";
+                std::string lab = prefix_label(st.include_prefixes[i]) + " ×";
                 if (ImGui::SmallButton(lab.c_str())) { st.include_prefixes.erase(st.include_prefixes.begin()+i); continue; }
                 ImGui::SameLine();
                 ++i;
@@ -479,22 +520,15 @@ static void render_filters_panel(struct AppGuiState& st) {
         if (hdr.empty()) hdr = "EXCLUDE PREFIXES";
         ImGui::SeparatorText(hdr.c_str());
 
-        std::vector<std::pair<int,std::string>> prefOptions;
-        build_prefix_options(prefOptions);
-
         std::string ph = l10n(st.bundle, "filters-select-prefix-exclude");
         if (ph.empty()) ph = "Select a prefix to exclude...";
-        if (ImGui::BeginCombo("##pref_exc", ph.c_str())) {
-            for (auto& opt : prefOptions) {
-                bool selected = (std::find(st.exclude_prefixes.begin(), st.exclude_prefixes.end(), opt.first) != st.exclude_prefixes.end());
-                if (ImGui::Selectable(opt.second.c_str(), selected)) {
-                    if (!selected && (int)st.exclude_prefixes.size() < ui_constants::kMaxFilterItems) {
-                        st.exclude_prefixes.push_back(opt.first);
-                    }
-                }
-                if (selected) ImGui::SetItemDefaultFocus();
+        int picked = 0;
+        if (views::filters::option_index::combo("##pref_exc", prefOptions,
+                views::filters::option_index::selection(prefOptions, st.exclude_prefixes), picked, ph.c_str())) {
+            if (std::find(st.exclude_prefixes.begin(), st.exclude_prefixes.end(), picked) == st.exclude_prefixes.end() &&
+                (int)st.exclude_prefixes.size() < ui_constants::kMaxFilterItems) {
+                st.exclude_prefixes.push_back(picked);
             }
-            ImGui::EndCombo();
         }
 
         // Render removable chips
@@ -503,15 +537,7 @@ static void render_filters_panel(struct AppGuiState& st) {
             ImGui::SameLine();
             ImGui::BeginGroup();
             for (size_t i=0;i<st.exclude_prefixes.size();) {
-                int id = st.exclude_prefixes[i];
-                // Find name
-                std::string name;
-                {
-                    std::vector<std::pair<int,std::string>> opts; build_prefix_options(opts);
-                    auto it = std::find_if(opts.begin(), opts.end(), [&](auto& p){ return p.first == id; });
-                    name = (it==opts.end()? std::to_string(id) : it->second);
-                }
-                std::string lab = name + " ×";
+                std::string lab = prefix_label(st.exclude_prefixes[i]) + " ×";
                 if (ImGui::SmallButton(lab.c_str())) { st.exclude_prefixes.erase(st.exclude_prefixes.begin()+i); continue; }
                 ImGui::SameLine();
                 ++i;
@@ -583,6 +609,44 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         logger::warn("Tags not loaded");
     }
 
+    // Per-host mirror stats (ranks download links by measured speed/reliability)
+    if (app::host_stats::load()) {
+        logger::info("Host stats loaded");
+    }
+
+    // File cache (covers, pages) with an LRU byte budget
+    {
+        std::string cacheRoot = st.cfg.cache_folder.empty() ? std::string("cache") : st.cfg.cache_folder;
+        apply_cache_budgets(st.cfg);
+        if (app::cache::init(cacheRoot)) {
+            logger::info("Cache: " + std::to_string(app::cache::total_bytes() / (1024 * 1024)) + " MB in " + cacheRoot);
+        } else {
+            logger::warn("Cache unavailable: " + cacheRoot);
+        }
+        // Decoded card thumbnails, mapped at startup so visible covers need no decode
+        std::string thumbRoot = cacheRoot;
+        if (thumbRoot.back() != '/' && thumbRoot.back() != '\\') thumbRoot += '/';
+        thumbRoot += "thumbs";
+        if (!app::thumbs::init(thumbRoot)) logger::warn("Thumbnail store unavailable: " + thumbRoot);
+    }
+
+    // Content-addressed blob index: archives already on disk are reused instead of fetched again
+    {
+        std::string blobRoot = st.cfg.cache_folder.empty() ? std::string("blobs") : st.cfg.cache_folder;
+        if (!st.cfg.cache_folder.empty()) {
+            if (blobRoot.back() != '/' && blobRoot.back() != '\\') blobRoot += '/';
+            blobRoot += "blobs";
+        }
+        if (!app::blob_store::init(blobRoot)) logger::warn("Blob store unavailable: " + blobRoot);
+    }
+
+    // Restore the persisted downloads queue; unfinished items resume automatically
+    {
+        std::size_t resumed = app::downloads::open_journal("downloads.journal");
+        st.downloads_list = app::downloads::list();
+        if (resumed > 0) logger::info("Resumed " + std::to_string(resumed) + " download(s)");
+    }
+
     // Convert UTF-8 title to wide
     std::wstring wTitle = to_wide(titleUtf8);
 
@@ -692,11 +756,26 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
     // Setup Platform/Renderer backends
     ImGui_ImplWin32_Init(hwnd);
     ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
+    app::covers::pipeline().set_renderer(app::covers::PageOps{CreateCoverPage, UpdateCoverPage, DestroyCoverPage});
+    app::covers::pipeline().set_budget(st.cfg.cover_atlas_mb * 1024ull * 1024ull);
+    app::gallery::gallery().set_renderer(app::covers::PageOps{CreateCoverPage, UpdateCoverPage, DestroyCoverPage});
+
+    // Frame pacing: sleep until input, a background result, an animation tick or the idle timeout
+    auto& frames = app::frame_scheduler::scheduler();
+    frames.set_policy(app::frame_scheduler::Policy{(double)st.cfg.ui_max_fps, st.cfg.ui_idle_timeout_ms / 1000.0});
+    HANDLE wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    frames.set_waker([wakeEvent]() { SetEvent(wakeEvent); });
 
     // Main loop
     bool done = false;
     while (!done)
     {
+        const double wait = frames.wait_time(now_seconds());
+        if (wait > 0.0) {
+            const DWORD ms = (DWORD)(wait * 1000.0 + 0.999);
+            MsgWaitForMultipleObjectsEx(1, &wakeEvent, ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        }
+
         MSG msg;
         while (PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
         {
@@ -707,12 +786,25 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         }
         if (done)
             break;
+        if (IsIconic(hwnd)) {
+            // Nothing to show; sleep until the window receives a message
+            MsgWaitForMultipleObjectsEx(0, nullptr, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+            continue;
+        }
+        if (!frames.due(now_seconds()))
+            continue;
+        frames.begin_frame(now_seconds());
+        bool downloadsActive = false;
 
         // Start the Dear ImGui frame
         ImGui_ImplDX11_NewFrame();
         ImGui_ImplWin32_NewFrame();
         ImGui::NewFrame();
 
+        // Copy a few finished cover thumbnails (decoded off-thread) into the atlas
+        app::covers::pipeline().pump();
+        app::gallery::gallery().pump();
+
         // Basic UI skeleton: menu bar and panes placeholders
         if (ImGui::Begin(titleUtf8.c_str()))
         {
@@ -733,15 +825,21 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                 if (ImGui::Button(fetchLbl.empty() ? "Fetch & Parse" : fetchLbl.c_str())) {
                     std::map<std::string, std::string> hdrs;
                     if (!st.cookieHeader.empty()) hdrs["Cookie"] = st.cookieHeader;
-                    int status = 0;
-                    auto body = app::fetch::get_body(st.threadUrl, status, hdrs);
-                    if (status >= 200 && status < 300 && !body.empty()) {
-                        st.game = parser::parse_thread(body);
+                    // Served from cache when fresh; a stale copy shows at once and is refreshed in the background
+                    auto body = app::fetch::get_cached(st.threadUrl, hdrs,
+                                                       app::cache::Options{true, true, app::cache::kNsThread}).get();
+                    if (body) {
+                        st.game = parser::parse_thread(*body);
+                        app::host_stats::rank_links(st.game.links);
+                        // Ingest: give the game its id and resolve tags/prefixes/engine to catalog ids once
+                        views::cards::items::ingest(st.game, tags::index_for(st.catalog));
                         st.fetchedOk = true;
-                        st.fetchStatus = "OK " + std::to_string(status);
+                        st.fetchStatus = "OK";
+                        st.card_items.assign(1, st.game);
+                        ++st.card_items_gen;
                     } else {
                         st.fetchedOk = false;
-                        st.fetchStatus = "HTTP " + std::to_string(status);
+                        st.fetchStatus = "Fetch failed";
                     }
                 }
             }
@@ -766,9 +864,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                     // Left content
                     ImGui::BeginChild("CardsLeft", ImVec2(ImGui::GetContentRegionAvail().x - right_w - spacing, 0), false);
                     if (st.fetchedOk) {
-                        std::vector<parser::GameInfo> items;
-                        items.push_back(st.game);
-                        views::cards::draw_cards_grid(items, (float)ui_constants::kCardWidth, &st.cfg, &st.catalog);
+                        views::cards::draw_cards_grid(st.card_items, st.card_items_gen, (float)ui_constants::kCardWidth, &st.cfg, &st.catalog);
                     } else {
                         { std::string nd = l10n(st.bundle, "ui-no-data"); ImGui::TextUnformatted(nd.empty() ? "No data. Enter thread URL and press Fetch & Parse." : nd.c_str()); }
                     }
@@ -802,6 +898,14 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                     static char urlsBuf[4096] = {0};
                     ImGui::InputTextMultiline("##urls", urlsBuf, sizeof(urlsBuf), ImVec2(800, 100));
 
+                    // Expected SHA-256 (optional): reuses a stored copy and rejects mirrors serving other bytes
+                    static char shaBuf[80] = {0};
+                    {
+                        std::string shaHint = l10n(st.bundle, "downloads-sha256");
+                        ImGui::SetNextItemWidth(600.0f);
+                        ImGui::InputTextWithHint("##sha256", shaHint.empty() ? "SHA-256 (optional)" : shaHint.c_str(), shaBuf, sizeof(shaBuf));
+                    }
+
                     // Enqueue
                     if (([&](){ std::string enqLbl = l10n(st.bundle, "downloads-enqueue"); return ImGui::Button(enqLbl.empty() ? "Enqueue" : enqLbl.c_str()); })()) {
                         // Parse lines
@@ -819,8 +923,12 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                             }
                             if (!cur.empty()) urls.push_back(cur);
                         }
-                        if (!urls.empty() && !st.downloads_target_dir.empty()) {
+                        const std::string sha = app::downloads::parse_sha256(shaBuf);
+                        if (shaBuf[0] != '\0' && sha.empty()) {
+                            st.downloads_info = "SHA-256 must be 64 hex digits";
+                        } else if (!urls.empty() && !st.downloads_target_dir.empty()) {
                             app::downloads::Item it;
+                            it.sha256 = sha;
                             it.title = ""; // filename from URL
                             it.target_dir = st.downloads_target_dir;
                             it.urls = std::move(urls);
@@ -836,6 +944,68 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
 
                     ImGui::Separator();
 
+                    // Update an installed game from its extracted new version: only new and
+                    // changed files are written; files are deleted only when a recorded
+                    // install manifest lists them.
+                    {
+                        auto lbl = [&](const char* key, const char* fallback) {
+                            std::string v = l10n(st.bundle, key);
+                            return v.empty() ? std::string(fallback) : v;
+                        };
+                        static char stagedBuf[1024] = {0};
+                        static char gameBuf[1024] = {0};
+                        ImGui::TextUnformatted(lbl("downloads-install-header", "Installed game").c_str());
+                        ImGui::SetNextItemWidth(600.0f);
+                        if (ImGui::InputTextWithHint("##install_game", lbl("downloads-install-game-dir", "Game folder").c_str(), gameBuf, sizeof(gameBuf)))
+                            st.install_game_dir = gameBuf;
+                        ImGui::SetNextItemWidth(600.0f);
+                        if (ImGui::InputTextWithHint("##install_staged", lbl("downloads-install-staged-dir", "Extracted new version").c_str(), stagedBuf, sizeof(stagedBuf)))
+                            st.install_staged_dir = stagedBuf;
+
+                        if (st.install_job) {
+                            std::lock_guard<std::mutex> lk(st.install_job->m);
+                            if (st.install_job->done) {
+                                st.install_info = st.install_job->info;
+                                st.install_job.reset();
+                            }
+                        }
+                        const bool busy = st.install_job != nullptr;
+                        auto run = [&](bool update) {
+                            auto job = std::make_shared<AppGuiState::InstallJob>();
+                            st.install_job = job;
+                            st.install_info = "Working...";
+                            app::runtime::schedule([job, update, staged = st.install_staged_dir, game = st.install_game_dir]() {
+                                std::string info;
+                                if (update) {
+                                    const auto r = app::install::apply_update(staged, game);
+                                    info = r.ok ? "Updated: " + std::to_string(r.written) + " written, " + std::to_string(r.removed) +
+                                                      " removed, " + std::to_string(r.unchanged) + " unchanged"
+                                                : "Update failed: " + r.error;
+                                } else {
+                                    info = app::install::record_install(game) ? "Install recorded" : "Failed to record install";
+                                }
+                                logger::info(info + " (" + game + ")");
+                                {
+                                    std::lock_guard<std::mutex> lk(job->m);
+                                    job->info = std::move(info);
+                                    job->done = true;
+                                }
+                                app::frame_scheduler::scheduler().request_redraw();
+                            });
+                        };
+                        ImGui::BeginDisabled(busy || st.install_game_dir.empty());
+                        if (ImGui::Button(lbl("downloads-install-record", "Record install").c_str())) run(false);
+                        ImGui::SameLine();
+                        ImGui::BeginDisabled(st.install_staged_dir.empty());
+                        if (ImGui::Button(lbl("downloads-install-update", "Apply update").c_str())) run(true);
+                        ImGui::EndDisabled();
+                        ImGui::EndDisabled();
+                        ImGui::SameLine();
+                        ImGui::TextUnformatted(st.install_info.c_str());
+                    }
+
+                    ImGui::Separator();
+
                     // List current downloads
                     if (st.downloads_list.empty()) {
                         { std::string emptyLbl = l10n(st.bundle, "downloads-no-items"); ImGui::TextUnformatted(emptyLbl.empty() ? "No downloads enqueued." : emptyLbl.c_str()); }
@@ -843,6 +1013,8 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                         for (auto& p : st.downloads_list) {
                             auto id = p.first;
                             auto prog = app::downloads::query(id);
+                            if (prog.status == app::downloads::Status::Queued || prog.status == app::downloads::Status::Running)
+                                downloadsActive = true;
                             float frac = 0.0f;
                             if (prog.bytes_total > 0) frac = (float)((double)prog.bytes_done / (double)prog.bytes_total);
                             ImGui::Text("ID %llu: %s", (unsigned long long)id, prog.message.c_str());
@@ -902,16 +1074,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
 
                     // Log content
                     ImGui::Separator();
-                    ImGui::BeginChild("logs_scroll", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
-                    auto lines = logger::lines();
-                    for (auto& s : lines) {
-                        ImGui::TextUnformatted(s.c_str());
-                    }
-                    if (st.logs_autoscroll && lines.size() > st.logs_prev_line_count) {
-                        ImGui::SetScrollHereY(1.0f);
-                    }
-                    st.logs_prev_line_count = lines.size();
-                    ImGui::EndChild();
+                    views::logs::draw_log_lines(st.logs_autoscroll, st.logs_prev_line_count);
 
                     ImGui::EndTabItem();
                 }
@@ -954,8 +1117,23 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
                     ImGui::Checkbox("Log to file", &st.cfg_log_to_file);
                     st.cfg.log_to_file = st.cfg_log_to_file;
 
+                    // Cache and cover texture budgets (applied on save)
+                    {
+                        int cache_mb = (int)st.cfg.cache_max_mb;
+                        ImGui::SetNextItemWidth(200.0f);
+                        if (ImGui::InputInt("Cache size limit (MB, 0 = unlimited)", &cache_mb, 256, 1024))
+                            st.cfg.cache_max_mb = (std::uint64_t)(cache_mb < 0 ? 0 : cache_mb);
+                        int atlas_mb = (int)st.cfg.cover_atlas_mb;
+                        ImGui::SetNextItemWidth(200.0f);
+                        if (ImGui::InputInt("Cover texture memory (MB)", &atlas_mb, 16, 64))
+                            st.cfg.cover_atlas_mb = (std::uint64_t)(atlas_mb < 16 ? 16 : atlas_mb);
+                    }
+
                     if (ImGui::Button("Save Config")) {
                         if (app::settings::Store::save("config.json", st.cfg)) {
+                            // Budgets take effect without a restart; a smaller cache evicts now
+                            apply_cache_budgets(st.cfg);
+                            app::covers::pipeline().set_budget(st.cfg.cover_atlas_mb * 1024ull * 1024ull);
                             logger::info("Config saved.");
                         } else {
                             logger::error("Failed to save config.");
@@ -973,6 +1151,13 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         // Modals / overlays (must be called while frame is active)
         app::about_ui::show_about_dialog(st.about_open, st.bundle);
 
+        // Keep frames coming while something changes on its own
+        frames.set_animating(downloadsActive || ImGui::IsAnyItemActive() || ImGui::GetIO().WantTextInput ||
+                             app::covers::pipeline().has_ready() || app::gallery::gallery().has_ready());
+        // A hovered item may show a tooltip or highlight once the pointer has rested a while
+        if (ImGui::IsAnyItemHovered())
+            frames.hold_after_input(ImGui::GetStyle().HoverDelayNormal + 0.1);
+
         // Rendering
         ImGui::Render();
         const float clear_color_with_alpha[4] = { 0.10f, 0.10f, 0.12f, 1.0f };
@@ -983,7 +1168,15 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
         g_pSwapChain->Present(1, 0);
     }
 
+    if (!app::host_stats::save()) {
+        logger::warn("Failed to save host stats.");
+    }
+
     // Cleanup
+    frames.set_waker(nullptr);
+    CloseHandle(wakeEvent);
+    app::covers::pipeline().clear();
+    app::gallery::gallery().clear();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
@@ -1001,6 +1194,11 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int)
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+    // Only real input wakes the frame scheduler; timers, paints and wake-ups do not
+    if ((msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST) || (msg >= WM_KEYFIRST && msg <= WM_KEYLAST) ||
+        msg == WM_MOUSELEAVE || msg == WM_SIZE || msg == WM_SETFOCUS || msg == WM_KILLFOCUS)
+        app::frame_scheduler::scheduler().on_input(now_seconds());
+
     if (ImGui_ImplWin32_WndProcHandler(hWnd, msg, wParam, lParam))
         return true;
 
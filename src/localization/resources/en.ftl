@@ -121,8 +121,14 @@ ui-no-data = No data. Enter thread URL and press Fetch & Parse.
 # Downloads panel
 downloads-target-dir = Target dir:
 downloads-urls = URLs (one per line):
+downloads-sha256 = SHA-256 (optional)
 downloads-enqueue = Enqueue
 downloads-no-items = No downloads enqueued.
+downloads-install-header = Installed game
+downloads-install-game-dir = Game folder
+downloads-install-staged-dir = Extracted new version
+downloads-install-record = Record install
+downloads-install-update = Apply update
 ui-cookie-header = Cookie header:
 
 # Common
@@ -123,5 +123,11 @@ ui-cookie-header = Заголовок Cookie:
 # Панель загрузок
 downloads-target-dir = Папка назначения:
 downloads-urls = URL-адреса (по одному в строке):
+downloads-sha256 = SHA-256 (необязательно)
 downloads-enqueue = В очередь
 downloads-no-items = Нет загрузок в очереди.
+downloads-install-header = Установленная игра
+downloads-install-game-dir = Папка игры
+downloads-install-staged-dir = Распакованная новая версия
+downloads-install-record = Записать установку
+downloads-install-update = Применить обновление
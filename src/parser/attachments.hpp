@@ -0,0 +1,65 @@
+#pragma once
+// F95 attachment URLs. The forum serves every uploaded image in two sizes:
+//   full:  https://attachments.f95zone.to/2024/05/3712345_cover.png
+//   thumb: https://attachments.f95zone.to/2024/05/thumb/3712345_cover.png
+// Thumbs are downscaled to roughly kThumbMaxWidth pixels and are a fraction of the
+// full file size. Threads are parsed to the full URL (one canonical key per image);
+// callers pick the variant they fetch with source_for() by the size they will draw at.
+
+#include <string>
+#include <cstddef>
+
+namespace parser {
+namespace attachments {
+
+inline constexpr const char* kHost = "https://attachments.f95zone.to/";
+inline constexpr const char* kThumbDir = "thumb/";
+inline constexpr int kThumbMaxWidth = 300; // approximate width of forum thumbs
+
+namespace detail {
+// Offset just past ".../<year>/<month>/", or npos if 'url' is not an attachment URL
+inline std::size_t dir_end(const std::string& url) {
+    const std::string host = kHost;
+    if (url.compare(0, host.size(), host) != 0) return std::string::npos;
+    std::size_t p = host.size();
+    for (int part = 0; part < 2; ++part) {
+        const std::size_t slash = url.find('/', p);
+        if (slash == std::string::npos || slash == p) return std::string::npos;
+        for (std::size_t i = p; i < slash; ++i) {
+            if (url[i] < '0' || url[i] > '9') return std::string::npos;
+        }
+        p = slash + 1;
+    }
+    return p;
+}
+} // namespace detail
+
+inline bool is_attachment(const std::string& url) { return detail::dir_end(url) != std::string::npos; }
+
+inline bool is_thumb(const std::string& url) {
+    const std::size_t p = detail::dir_end(url);
+    return p != std::string::npos && url.compare(p, std::char_traits<char>::length(kThumbDir), kThumbDir) == 0;
+}
+
+// Full-size URL for an attachment (thumb or full); other URLs are returned unchanged.
+inline std::string full_url(const std::string& url) {
+    if (!is_thumb(url)) return url;
+    const std::size_t p = detail::dir_end(url);
+    return url.substr(0, p) + url.substr(p + std::char_traits<char>::length(kThumbDir));
+}
+
+// Thumb URL for an attachment (thumb or full); other URLs are returned unchanged.
+inline std::string thumb_url(const std::string& url) {
+    const std::size_t p = detail::dir_end(url);
+    if (p == std::string::npos || is_thumb(url)) return url;
+    return url.substr(0, p) + kThumbDir + url.substr(p);
+}
+
+// URL to fetch for drawing 'url' at 'target_width' pixels: the thumb when it is
+// (about) large enough, the full image otherwise.
+inline std::string source_for(const std::string& url, int target_width) {
+    return target_width <= kThumbMaxWidth ? thumb_url(url) : full_url(url);
+}
+
+} // namespace attachments
+} // namespace parser
@@ -1,11 +1,14 @@
 #pragma once
 // High-level parser API (lightweight, regex-based) to approximate Rust parser behavior.
-// Parses basic thread metadata (title, author, version, tags) and link extraction.
+// Parses basic thread metadata (title, author, version, tags, cover/screenshot URLs) and link extraction.
 
 #include <string>
 #include <vector>
 #include <regex>
 #include <algorithm>
+#include <cstdint>
+
+#include "attachments.hpp"
 
 namespace parser {
 
@@ -43,6 +46,8 @@ struct ThreadMeta {
     std::string author;
     std::string version;
     std::vector<std::string> tags;
+    std::string cover;                // cover image URL (first screenshot if none is marked)
+    std::vector<std::string> screens; // full-size screenshot attachment URLs
 };
 
 struct LinkInfo {
@@ -54,6 +59,7 @@ struct LinkInfo {
 struct GameInfo {
     ThreadMeta meta;
     std::vector<LinkInfo> links;
+    std::uint64_t id = 0; // assigned by the app when the game is ingested; 0 = not yet
 };
 
 // naive HTML title extraction
@@ -113,6 +119,30 @@ inline std::vector<std::string> extract_tags(const std::string& html) {
     return out;
 }
 
+// Screenshot attachments linked from the page (https://attachments.f95zone.to/...), as
+// full-size URLs, deduplicated
+inline std::vector<std::string> extract_screens(const std::string& html) {
+    static const std::regex re(
+        R"re(href="(https://attachments\.f95zone\.to/\d+/\d+/(?:thumb/)?\d+_[A-Za-z0-9_\-]+\.[A-Za-z0-9]+(?:\?[^\s"'<>]*)?)")re",
+        std::regex::icase);
+    std::vector<std::string> out;
+    for (auto& link : regex_all(html, re, 1)) {
+        std::string u = attachments::full_url(link);
+        if (std::find(out.begin(), out.end(), u) == out.end()) out.push_back(u);
+    }
+    return out;
+}
+
+// Cover: first inline attachment image (full-size URL); falls back to the first screenshot
+inline std::string extract_cover(const std::string& html, const std::vector<std::string>& screens) {
+    static const std::regex re(
+        R"re(src="(https://attachments\.f95zone\.to/\d+/\d+/(?:thumb/)?\d+_[A-Za-z0-9_\-]+\.[A-Za-z0-9]+(?:\?[^\s"'<>]*)?)")re",
+        std::regex::icase);
+    std::string c = attachments::full_url(regex_first(html, re, 1));
+    if (c.empty() && !screens.empty()) c = screens.front();
+    return c;
+}
+
 inline std::string classify_provider(const std::string& url) {
     auto l = lower(url);
     if (l.find("gofile") != std::string::npos) return "gofile";
@@ -154,6 +184,8 @@ inline GameInfo parse_thread(const std::string& html) {
     gi.meta.author  = extract_author(html);
     gi.meta.version = extract_version(html);
     gi.meta.tags    = extract_tags(html);
+    gi.meta.screens = extract_screens(html);
+    gi.meta.cover   = extract_cover(html, gi.meta.screens);
     gi.links        = extract_links(html);
     return gi;
 }
@@ -0,0 +1,142 @@
+#pragma once
+// Purpose: Dense ids for tags and prefixes, so per-game matching is done once at ingest
+// and per-frame checks are bit operations.
+// Tags get ids by (case-insensitive) name: catalog tags first, names seen later on games
+// or in settings are interned after them. Prefixes get one id per catalog entry, in
+// catalog order (games, comics, animations, assets).
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+#include <algorithm>
+#include <cctype>
+
+#include "mod.hpp"
+
+namespace tags {
+
+// Growable bitset over dense ids
+class Bitset {
+public:
+    void set(int i) {
+        if (i < 0) return;
+        const std::size_t w = (std::size_t)i / 64;
+        if (w >= words_.size()) words_.resize(w + 1, 0);
+        words_[w] |= 1ull << ((std::size_t)i % 64);
+    }
+    bool test(int i) const {
+        const std::size_t w = (std::size_t)i / 64;
+        return i >= 0 && w < words_.size() && (words_[w] >> ((std::size_t)i % 64)) & 1u;
+    }
+    bool empty() const {
+        return std::all_of(words_.begin(), words_.end(), [](std::uint64_t w){ return w == 0; });
+    }
+    // popcount(*this & o)
+    int and_count(const Bitset& o) const {
+        int n = 0;
+        const std::size_t k = (std::min)(words_.size(), o.words_.size());
+        for (std::size_t i = 0; i < k; ++i) n += std::popcount(words_[i] & o.words_[i]);
+        return n;
+    }
+    // Call f(id) for every id set in both
+    template <class F> void for_each_and(const Bitset& o, F&& f) const {
+        const std::size_t k = (std::min)(words_.size(), o.words_.size());
+        for (std::size_t i = 0; i < k; ++i) {
+            for (std::uint64_t w = words_[i] & o.words_[i]; w; w &= w - 1) f((int)(i * 64 + (std::size_t)std::countr_zero(w)));
+        }
+    }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+inline std::string fold(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return (char)std::tolower(c); });
+    return s;
+}
+
+// Display form of a prefix name (the catalog stores HTML-escaped apostrophes)
+inline std::string unescape_name(std::string s) {
+    const std::string from = "&#039;";
+    std::size_t pos = 0;
+    while ((pos = s.find(from, pos)) != std::string::npos) {
+        s.replace(pos, from.size(), "'");
+        pos += 1;
+    }
+    return s;
+}
+
+struct Index {
+    // Tags
+    std::unordered_map<std::string, int> tag_ids; // folded name -> id
+    std::vector<std::string> tag_names;
+    // Prefixes: one per catalog entry
+    std::vector<std::string> prefix_names;  // display names
+    std::vector<std::string> prefix_folded; // folded raw names, for matching
+    std::unordered_map<std::string, std::vector<int>> prefixes_by_name; // folded name -> ids
+    std::vector<int> engine_prefixes;       // ids of the "Engine" group, in catalog order
+    // Identity of the catalog this was built from; changes whenever it is rebuilt
+    std::uint64_t generation = 0;
+
+    int tag_id(const std::string& name) const {
+        auto it = tag_ids.find(fold(name));
+        return it == tag_ids.end() ? -1 : it->second;
+    }
+    int intern_tag(const std::string& name) {
+        auto [it, added] = tag_ids.try_emplace(fold(name), (int)tag_names.size());
+        if (added) tag_names.push_back(name);
+        return it->second;
+    }
+    const std::vector<int>* prefix_ids(const std::string& name) const {
+        auto it = prefixes_by_name.find(fold(name));
+        return it == prefixes_by_name.end() ? nullptr : &it->second;
+    }
+};
+
+inline void build_index(const Catalog& cat, Index& ix) {
+    const std::uint64_t gen = ix.generation + 1;
+    ix = Index{};
+    ix.generation = gen;
+    // Catalog tags by id, so ids are stable for a given catalog
+    std::vector<std::pair<int, const std::string*>> sorted;
+    for (const auto& [id, name] : cat.tags) sorted.emplace_back(id, &name);
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b){ return a.first < b.first; });
+    for (const auto& t : sorted) ix.intern_tag(*t.second);
+    for (const auto* groups : {&cat.games, &cat.comics, &cat.animations, &cat.assets}) {
+        for (const auto& g : *groups) {
+            const bool engine = groups == &cat.games && fold(g.name) == "engine";
+            for (const auto& p : g.prefixes) {
+                const int id = (int)ix.prefix_names.size();
+                ix.prefix_names.push_back(unescape_name(p.name));
+                ix.prefix_folded.push_back(fold(p.name));
+                ix.prefixes_by_name[ix.prefix_folded.back()].push_back(id);
+                if (engine) ix.engine_prefixes.push_back(id);
+            }
+        }
+    }
+}
+
+// Cheap fingerprint of a catalog's size, to notice a reload into the same object
+inline std::size_t catalog_shape(const Catalog& cat) {
+    return cat.tags.size() * 1000003u + cat.games.size() * 1009u + cat.comics.size() * 101u +
+           cat.animations.size() * 11u + cat.assets.size();
+}
+
+// Index for 'cat', rebuilt when a different or reloaded catalog is passed. UI thread only.
+inline Index& index_for(const Catalog& cat) {
+    static Index ix;
+    static const Catalog* source = nullptr;
+    static std::size_t shape = 0;
+    const std::size_t s = catalog_shape(cat);
+    if (source != &cat || shape != s) {
+        build_index(cat, ix);
+        source = &cat;
+        shape = s;
+    }
+    return ix;
+}
+
+} // namespace tags
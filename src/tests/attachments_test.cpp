@@ -0,0 +1,96 @@
+// Unit tests for parser::attachments (full/thumb URL mapping, source_for) and for the
+// thread parser storing cover and screenshot links as full-size URLs.
+// Usage: f95_attachments_test
+
+#include <string>
+#include <vector>
+
+#include "parser/parser.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace att = parser::attachments;
+
+const std::string kFull = "https://attachments.f95zone.to/2024/05/3712345_cover.png";
+const std::string kThumb = "https://attachments.f95zone.to/2024/05/thumb/3712345_cover.png";
+
+void test_round_trip() {
+    CHECK(att::is_attachment(kFull) && att::is_attachment(kThumb));
+    CHECK(!att::is_thumb(kFull) && att::is_thumb(kThumb));
+    CHECK(att::full_url(kThumb) == kFull);
+    CHECK(att::full_url(kFull) == kFull);
+    CHECK(att::thumb_url(kFull) == kThumb);
+    CHECK(att::thumb_url(kThumb) == kThumb);
+    CHECK(att::full_url(att::thumb_url(kFull)) == kFull);
+
+    // Query strings ride along
+    const std::string q = "https://attachments.f95zone.to/2023/11/thumb/99_a-b.jpg?x=1";
+    CHECK(att::full_url(q) == "https://attachments.f95zone.to/2023/11/99_a-b.jpg?x=1");
+}
+
+void test_other_urls() {
+    const std::vector<std::string> others = {
+        "",
+        "https://f95zone.to/threads/some-game.1234/",
+        "https://attachments.f95zone.to/",
+        "http://attachments.f95zone.to/2024/05/thumb/1_a.png", // not https
+        "https://attachments.f95zone.to/2024/thumb/1_a.png",   // one date part
+        "https://attachments.f95zone.to/2024//1_a.png",        // empty month
+        "https://attachments.f95zone.to/20a4/05/1_a.png",      // non-numeric year
+        "https://attachments.f95zone.to/data/avatars/1.jpg",
+    };
+    for (const auto& u : others) {
+        CHECK(!att::is_attachment(u));
+        CHECK(!att::is_thumb(u));
+        CHECK(att::full_url(u) == u);
+        CHECK(att::thumb_url(u) == u);
+        CHECK(att::source_for(u, 100) == u);
+        CHECK(att::source_for(u, 1000) == u);
+    }
+    // "thumb" as a file name prefix is not the thumb directory
+    const std::string named = "https://attachments.f95zone.to/2024/05/thumbnail_1.png";
+    CHECK(att::is_attachment(named) && !att::is_thumb(named));
+    CHECK(att::full_url(named) == named);
+}
+
+void test_source_for() {
+    CHECK(att::source_for(kFull, 280) == kThumb);
+    CHECK(att::source_for(kThumb, 280) == kThumb);
+    CHECK(att::source_for(kFull, att::kThumbMaxWidth) == kThumb);
+    CHECK(att::source_for(kFull, att::kThumbMaxWidth + 1) == kFull);
+    CHECK(att::source_for(kThumb, 600) == kFull);
+    CHECK(att::source_for(kFull, 600) == kFull);
+}
+
+void test_parse_thread() {
+    const std::string html =
+        "<h1 class=\"p-title-value\">Game [v0.1] [Dev]</h1>"
+        "<img src=\"" + kThumb + "\" />"
+        "<a href=\"https://attachments.f95zone.to/2024/05/thumb/3712346_s1.jpg\">s1</a>"
+        "<a href=\"https://attachments.f95zone.to/2024/05/3712346_s1.jpg\">s1 again</a>"
+        "<a href=\"https://attachments.f95zone.to/2024/05/3712347_s2.webp\">s2</a>";
+    const auto gi = parser::parse_thread(html);
+    CHECK(gi.meta.cover == kFull);
+    CHECK(gi.meta.screens.size() == 2);
+    if (gi.meta.screens.size() == 2) {
+        CHECK(gi.meta.screens[0] == "https://attachments.f95zone.to/2024/05/3712346_s1.jpg");
+        CHECK(gi.meta.screens[1] == "https://attachments.f95zone.to/2024/05/3712347_s2.webp");
+    }
+    for (const auto& s : gi.meta.screens) CHECK(!att::is_thumb(s));
+
+    // No inline image: the cover falls back to the first (full-size) screenshot
+    const auto no_img = parser::parse_thread(
+        "<a href=\"https://attachments.f95zone.to/2024/05/thumb/3712346_s1.jpg\">s1</a>");
+    CHECK(no_img.meta.cover == "https://attachments.f95zone.to/2024/05/3712346_s1.jpg");
+}
+
+} // namespace
+
+int main() {
+    test_round_trip();
+    test_other_urls();
+    test_source_for();
+    test_parse_thread();
+    return check::result();
+}
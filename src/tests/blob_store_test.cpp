@@ -0,0 +1,103 @@
+// Unit tests for app::blob_store: adopting a download records a reference without
+// copying, materializing copies from a live reference, and references to files that
+// changed or vanished are collected along with their digest and prefix entries.
+// Usage: f95_blob_store_test
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+
+#include "app/blob_store.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+namespace blobs = app::blob_store;
+
+const std::string kHex(64, 'a');
+const std::string kPrefix(64, 'b');
+
+void write(const fs::path& p, const std::string& body) {
+    fs::create_directories(p.parent_path());
+    std::ofstream(p, std::ios::binary | std::ios::trunc) << body;
+}
+
+std::string read(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::size_t file_count(const fs::path& dir) {
+    std::size_t n = 0;
+    for (const auto& e : fs::recursive_directory_iterator(dir)) n += e.is_regular_file() ? 1 : 0;
+    return n;
+}
+
+void test_adopt_and_materialize(const fs::path& dir) {
+    const fs::path root = dir / "blobs";
+    CHECK(blobs::init(root.string()));
+
+    const fs::path a = dir / "games" / "a" / "pack.zip";
+    write(a, "payload");
+    CHECK(blobs::adopt(a.string(), kHex, kPrefix, 7));
+    CHECK(!blobs::adopt(a.string(), kHex, kPrefix, 8)); // size must match the file
+    CHECK(blobs::references(kHex) == 1);
+    CHECK(blobs::lookup_prefix(kPrefix, 7) == kHex);
+    CHECK(blobs::lookup_prefix(kPrefix, 8).empty());
+    // Nothing was copied into the store: only the index lives there
+    CHECK(file_count(root) == 1);
+
+    const fs::path b = dir / "games" / "b" / "pack.zip";
+    CHECK(blobs::materialize(kHex, b.string()));
+    CHECK(read(b) == "payload");
+    CHECK(blobs::references(kHex) == 2);
+    CHECK(blobs::materialize(kHex, a.string())); // already in place
+
+    // The index survives a restart
+    CHECK(blobs::init(root.string()));
+    CHECK(blobs::references(kHex) == 2);
+    CHECK(blobs::lookup_prefix(kPrefix, 7) == kHex);
+}
+
+void test_gc(const fs::path& dir) {
+    const fs::path root = dir / "blobs";
+    const fs::path a = dir / "games" / "a" / "pack.zip";
+    const fs::path b = dir / "games" / "b" / "pack.zip";
+
+    // A game update rewrites one copy in place: that reference no longer holds the blob
+    write(a, "patched payload");
+    CHECK(blobs::gc() == 1);
+    CHECK(blobs::references(kHex) == 1);
+
+    // Materializing skips the stale file and copies from the one still intact
+    const fs::path c = dir / "games" / "c" / "pack.zip";
+    CHECK(blobs::materialize(kHex, c.string()));
+    CHECK(read(c) == "payload");
+
+    fs::remove(b);
+    fs::remove(c);
+    CHECK(blobs::gc() == 2);
+    CHECK(!blobs::has(kHex));
+    CHECK(blobs::lookup_prefix(kPrefix, 7).empty());
+    CHECK(!blobs::materialize(kHex, (dir / "games" / "d" / "pack.zip").string()));
+
+    // Forgotten for good
+    CHECK(blobs::init(root.string()));
+    CHECK(blobs::references(kHex) == 0);
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "f95_blob_store_test";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+
+    test_adopt_and_materialize(dir);
+    test_gc(dir);
+
+    fs::remove_all(dir, ec);
+    return check::result();
+}
@@ -0,0 +1,118 @@
+// Unit tests for app::cache: file writes replace a packed entry for the same key,
+// put_move(keep_source) never shares data with the caller, entries without a recorded
+// origin (adopted or found on disk) are never served, and the index is flushed per
+// record and reconciled with the directory on open.
+// Usage: f95_cache_test
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <filesystem>
+
+#include "app/cache.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+namespace cache = app::cache;
+
+std::vector<std::uint8_t> bytes(const std::string& s) { return std::vector<std::uint8_t>(s.begin(), s.end()); }
+
+void write(const fs::path& p, const std::string& body) {
+    fs::create_directories(p.parent_path());
+    std::ofstream(p, std::ios::binary | std::ios::trunc) << body;
+}
+
+std::string read(const std::string& p) {
+    std::ifstream in(cache::u8path(p), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void test_file_writes_drop_packed(const fs::path& dir) {
+    const fs::path src = dir / "src.bin";
+    write(src, "from put");
+    CHECK(cache::put_packed("k-put", bytes("packed")));
+    CHECK(cache::put("k-put", src.string()));
+    CHECK(!cache::get_packed("k-put"));
+    CHECK(read(cache::get("k-put")) == "from put");
+
+    CHECK(cache::put_packed("k-move", bytes("packed")));
+    CHECK(cache::put_move("k-move", src.string()));
+    CHECK(!cache::get_packed("k-move"));
+    CHECK(read(cache::get("k-move")) == "from put");
+    CHECK(!fs::exists(src));
+
+    // Keeping the source gives the entry its own data: rewriting the source leaves it alone
+    write(src, "caller's");
+    CHECK(cache::put_move("k-keep", src.string(), true));
+    CHECK(fs::exists(src));
+    CHECK(fs::hard_link_count(cache::u8path(cache::path_for("k-keep"))) == 1);
+    std::ofstream(src, std::ios::binary | std::ios::in | std::ios::out) << "CALLER";
+    CHECK(read(cache::get("k-keep")) == "caller's");
+
+    CHECK(cache::put_packed("k-bytes", bytes("packed")));
+    CHECK(cache::put_bytes("k-bytes", bytes("from bytes")));
+    CHECK(!cache::get_packed("k-bytes"));
+    CHECK(read(cache::get("k-bytes")) == "from bytes");
+}
+
+void test_no_origin() {
+    // A hashed file the index does not list: its key cannot be verified
+    const std::string orphan = cache::path_for("orphan");
+    write(cache::u8path(orphan), "whose?");
+    CHECK(cache::get("orphan").empty());
+    CHECK(!fs::exists(cache::u8path(orphan)));
+
+    // Adopted with no origin (index lost): counted, but not served
+    write(cache::u8path(cache::path_for("adopted")), "whose?");
+    cache::index().on_put(cache::hashed_name("adopted"), 6, 0);
+    CHECK(cache::get("adopted").empty());
+    CHECK(!cache::index().contains(cache::hashed_name("adopted")));
+
+    // Written through the API afterwards: served again
+    CHECK(cache::put_bytes("adopted", bytes("mine")));
+    CHECK(read(cache::get("adopted")) == "mine");
+
+    // Packed value the index does not know about
+    CHECK(cache::packs().put(cache::packed_name("lost"), bytes("whose?")));
+    CHECK(!cache::get_packed("lost"));
+    CHECK(!cache::packs().contains(cache::packed_name("lost")));
+}
+
+void test_index_on_disk(const fs::path& dir) {
+    const fs::path idx = dir / "cache" / "cache.idx";
+    CHECK(cache::put_bytes("k-idx", bytes("12345")));
+    // Flushed as written: a crash now would not lose the record
+    CHECK(read(idx.string()).find(cache::hashed_name("k-idx")) != std::string::npos);
+
+    // The index lost track of one file and another vanished behind its back
+    write(cache::u8path(cache::path_for("stray")), "1234567");
+    fs::remove(cache::u8path(cache::path_for("k-idx")));
+    const std::uint64_t before = cache::total_bytes();
+
+    cache::index().open(idx.string());
+    cache::reconcile_with_disk();
+    CHECK(cache::index().contains(cache::hashed_name("stray")));
+    CHECK(!cache::index().contains(cache::hashed_name("k-idx")));
+    CHECK(cache::total_bytes() == before + 7 - 5);
+}
+
+} // namespace
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "f95_cache_test";
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+    CHECK(cache::init((dir / "cache").string()));
+
+    test_file_writes_drop_packed(dir);
+    test_no_origin();
+    test_index_on_disk(dir);
+
+    cache::index().close();
+    fs::remove_all(dir, ec);
+    return check::result();
+}
@@ -0,0 +1,105 @@
+// Unit tests for the app::cache load pool: misses and background refreshes share a
+// bounded set of workers, refreshes never hold more than kMaxRefreshRunning of them, and
+// get_or_load_sync runs its load on the calling thread.
+// Usage: f95_cache_tier_test
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "app/cache_tier.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace cache = app::cache;
+using namespace std::chrono_literals;
+
+// Loader that stays busy for a while and records how many loads overlapped
+struct Busy {
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> calls{0};
+
+    cache::Loader loader(const std::string& value) {
+        return [this, value]() -> cache::Value {
+            const int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(10ms);
+            --running;
+            ++calls;
+            return std::make_shared<const std::string>(value);
+        };
+    }
+};
+
+const cache::Options kMemoryOnly{true, false, std::string()};
+
+void test_misses_bounded() {
+    Busy busy;
+    std::vector<std::shared_future<cache::Value>> futs;
+    for (int i = 0; i < 40; ++i) {
+        const std::string key = "miss" + std::to_string(i);
+        futs.push_back(cache::get_or_load(key, busy.loader(key), kMemoryOnly));
+    }
+    bool all = true;
+    for (int i = 0; i < 40; ++i) {
+        cache::Value v = futs[i].get();
+        all = all && v && *v == "miss" + std::to_string(i);
+    }
+    CHECK(all);
+    CHECK(busy.calls == 40);
+    CHECK(busy.peak <= cache::kLoadWorkers);
+    CHECK(busy.peak > 1);
+}
+
+void test_refreshes_capped() {
+    cache::set_policy("t", cache::Policy{10, 100000});
+    const cache::Options opt{true, false, "t"};
+    const std::int64_t old = std::time(nullptr) - 20;
+    for (int i = 0; i < 20; ++i) {
+        cache::memory().put("stale" + std::to_string(i), std::make_shared<const std::string>("old"), old);
+    }
+    Busy busy;
+    for (int i = 0; i < 20; ++i) {
+        const std::string key = "stale" + std::to_string(i);
+        cache::Value v = cache::get_or_load(key, busy.loader("new"), opt).get();
+        CHECK(v && *v == "old"); // served at once
+    }
+    for (int spins = 0; busy.calls < 20 && spins < 500; ++spins) std::this_thread::sleep_for(5ms);
+    CHECK(busy.calls == 20);
+    CHECK(busy.peak <= cache::kMaxRefreshRunning);
+    auto refreshing = [] {
+        auto& f = cache::detail::inflight();
+        std::lock_guard<std::mutex> lk(f.m);
+        return !f.refreshing.empty();
+    };
+    for (int spins = 0; refreshing() && spins < 500; ++spins) std::this_thread::sleep_for(5ms);
+    cache::Value v = cache::memory().get("stale19");
+    CHECK(v && *v == "new");
+}
+
+void test_sync_on_caller() {
+    std::thread::id ran_on;
+    cache::Value v = cache::get_or_load_sync("sync", [&]() -> cache::Value {
+        ran_on = std::this_thread::get_id();
+        return std::make_shared<const std::string>("x");
+    }, kMemoryOnly);
+    CHECK(v && *v == "x");
+    CHECK(ran_on == std::this_thread::get_id());
+    // Now a memory hit: the loader is not called again
+    CHECK(*cache::get_or_load_sync("sync", []() -> cache::Value { return nullptr; }, kMemoryOnly) == "x");
+}
+
+} // namespace
+
+int main() {
+    test_misses_bounded();
+    test_refreshes_capped();
+    test_sync_on_caller();
+    return check::result();
+}
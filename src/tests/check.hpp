@@ -0,0 +1,28 @@
+#pragma once
+// Minimal assertion helpers for the unit test executables (no framework dependency).
+// CHECK keeps going after a failure so one run reports every broken expectation;
+// main() returns check::result() so ctest sees the failure count.
+
+#include <cstdio>
+
+namespace check {
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+inline void fail(const char* expr, const char* file, int line) {
+    std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", file, line, expr);
+    ++failures();
+}
+
+inline int result() {
+    if (failures() == 0) std::printf("ok\n");
+    else std::fprintf(stderr, "%d check(s) failed\n", failures());
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace check
+
+#define CHECK(expr) ((expr) ? (void)0 : ::check::fail(#expr, __FILE__, __LINE__))
@@ -0,0 +1,197 @@
+// Randomized test for app::covers::Atlas with fake PageOps. Pages are CPU grids that
+// record which thumbnail wrote each texel; after every frame each resident thumbnail must
+// still own its whole rectangle (no overlaps, nothing overwritten), stay inside its page
+// and never point at a destroyed page. Inserts may only fail while everything resident
+// was drawn in this or the previous frame, and every eviction is reported to on_evict.
+// Usage: f95_cover_atlas_test [seed]
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <iterator>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include "app/cover_atlas.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+using namespace app::covers;
+
+constexpr int kPage = 256;
+
+struct FakePage {
+    std::vector<int> owner = std::vector<int>((std::size_t)kPage * kPage, 0);
+    bool alive = true;
+};
+
+struct Fake {
+    std::map<Texture, std::unique_ptr<FakePage>> pages;
+    Texture next = 1;
+    int bad_writes = 0;
+
+    PageOps ops() {
+        PageOps o;
+        o.create = [this](int size) -> Texture {
+            CHECK(size == kPage);
+            pages[next] = std::make_unique<FakePage>();
+            return next++;
+        };
+        o.update = [this](Texture t, int x, int y, const Pixels& px) {
+            auto it = pages.find(t);
+            if (it == pages.end() || !it->second->alive || x < 0 || y < 0 || x + px.width > kPage || y + px.height > kPage) {
+                ++bad_writes;
+                return;
+            }
+            // The first texel carries the writer's id (see pixels_for)
+            int id = 0;
+            std::memcpy(&id, px.rgba, sizeof(id));
+            for (int r = 0; r < px.height; ++r)
+                for (int c = 0; c < px.width; ++c) it->second->owner[(std::size_t)(y + r) * kPage + x + c] = id;
+        };
+        o.destroy = [this](Texture t) {
+            auto it = pages.find(t);
+            if (it == pages.end() || !it->second->alive) ++bad_writes;
+            else it->second->alive = false;
+        };
+        return o;
+    }
+
+    std::size_t alive() const {
+        std::size_t n = 0;
+        for (const auto& kv : pages) n += kv.second->alive ? 1 : 0;
+        return n;
+    }
+};
+
+struct Resident {
+    int id = 0;
+    int w = 0, h = 0;
+    Sprite sprite;
+    std::uint64_t last_used = 0;
+};
+
+// Texel origin of a sprite (undoes the half-texel inset)
+void origin_of(const Sprite& s, int& x, int& y) {
+    x = (int)std::lround(s.u0 * kPage - 0.5f);
+    y = (int)std::lround(s.v0 * kPage - 0.5f);
+}
+
+std::vector<std::uint8_t> pixels_for(int id, int w, int h) {
+    std::vector<std::uint8_t> px((std::size_t)w * h * 4, 0);
+    std::memcpy(px.data(), &id, sizeof(id));
+    return px;
+}
+
+bool verify(const Atlas& atlas, const Fake& fake, const std::map<std::string, Resident>& model, std::uint64_t max_pages) {
+    bool ok = true;
+    for (const auto& [key, r] : model) {
+        int x = 0, y = 0;
+        origin_of(r.sprite, x, y);
+        auto it = fake.pages.find(r.sprite.page);
+        if (it == fake.pages.end() || !it->second->alive || x < 0 || y < 0 || x + r.w > kPage || y + r.h > kPage) {
+            ok = false;
+            continue;
+        }
+        for (int row = 0; row < r.h && ok; ++row)
+            for (int c = 0; c < r.w; ++c)
+                if (it->second->owner[(std::size_t)(y + row) * kPage + x + c] != r.id) { ok = false; break; }
+    }
+    CHECK(atlas.resident() == model.size());
+    CHECK(fake.alive() == atlas.pages());
+    CHECK(atlas.pages() <= max_pages);
+    CHECK(fake.bad_writes == 0);
+    return ok;
+}
+
+void run(unsigned seed) {
+    std::mt19937 rng(seed);
+    Fake fake;
+    std::uint64_t max_pages = 3;
+    Atlas atlas(kPage, max_pages * kPage * kPage * 4);
+    atlas.set_ops(fake.ops());
+
+    std::map<std::string, Resident> model;
+    // Entries evicted to make room leave the model through the callback
+    atlas.set_on_evict([&](const std::string& key){
+        CHECK(model.count(key) == 1);
+        model.erase(key);
+    });
+    std::uint64_t frame = 1;
+    int next_id = 1;
+    const int heights[] = {24, 32, 40, 48, 64};
+
+    for (int f = 0; f < 300; ++f) {
+        atlas.begin_frame();
+        ++frame;
+        // A window of keys is "on screen" and drawn every frame, like a scrolling grid
+        const int view = (int)(rng() % 60);
+        for (int step = 0; step < 30; ++step) {
+            const int op = (int)(rng() % 10);
+            const std::string key = "k" + std::to_string(rng() % 120);
+            if (op < 5) {
+                const int h = heights[rng() % 5] - (int)(rng() % 6);
+                const int w = 8 + (int)(rng() % 72);
+                const int id = next_id++;
+                const auto px = pixels_for(id, w, h);
+                model.erase(key); // insert replaces
+                const Sprite s = atlas.insert(key, Pixels{w, h, px.data()});
+                for (const auto& kv : model) CHECK(atlas.contains(kv.first));
+                if (s) {
+                    model[key] = Resident{id, w, h, s, frame};
+                } else {
+                    for (const auto& kv : model) CHECK(kv.second.last_used + 1 >= frame);
+                }
+            } else if (op < 7) {
+                atlas.erase(key);
+                model.erase(key);
+            } else {
+                auto it = model.find(key);
+                const Sprite s = atlas.find(key);
+                CHECK((bool)s == (it != model.end()));
+                if (it != model.end()) {
+                    CHECK(s.page == it->second.sprite.page && s.u0 == it->second.sprite.u0 && s.v0 == it->second.sprite.v0);
+                    it->second.last_used = frame;
+                }
+            }
+        }
+        if (!verify(atlas, fake, model, max_pages)) {
+            std::fprintf(stderr, "seed %u frame %d: resident thumbnail damaged\n", seed, f);
+            check::fail("verify", __FILE__, __LINE__);
+            return;
+        }
+        // Draw the visible window
+        for (int k = view; k < view + 20; ++k) {
+            auto it = model.find("k" + std::to_string(k));
+            if (it != model.end() && atlas.find(it->first)) it->second.last_used = frame;
+        }
+        // Occasionally shrink or grow the budget; extra pages go once they empty
+        if (f % 97 == 96) {
+            max_pages = max_pages == 3 ? 2 : 3;
+            atlas.set_budget(max_pages * kPage * kPage * 4);
+            for (int k = 0; k < 120; ++k) {
+                atlas.erase("k" + std::to_string(k));
+                model.erase("k" + std::to_string(k));
+            }
+            CHECK(atlas.pages() <= max_pages);
+        }
+    }
+    atlas.clear();
+    CHECK(fake.alive() == 0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        run((unsigned)std::strtoul(argv[1], nullptr, 10));
+    } else {
+        for (unsigned seed = 1; seed <= 5; ++seed) run(seed);
+    }
+    return check::result();
+}
@@ -0,0 +1,315 @@
+// Fault-injection tests for app::downloads::Manager: a scripted Transport stands in for
+// WinHTTP and fails, throttles or truncates requests, so the retry loop, Range resume,
+// mirror fallback, the circuit breaker's release on cancel, resuming after a shutdown and
+// the journal's history cap run without a network.
+// Usage: f95_downloads_test
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <functional>
+#include <filesystem>
+
+#include "app/downloads.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+using namespace app::downloads;
+namespace retry = app::retry;
+using Step = std::function<Fault(const Request&, const Transport::OnHead&, const Transport::OnData&, std::string&)>;
+
+// Runs one scripted step per request and records what was asked for
+struct Fake {
+    std::mutex m;
+    std::vector<Request> requests;
+    std::vector<std::chrono::steady_clock::time_point> times;
+    std::vector<Step> steps;
+    Step otherwise; // after the script
+
+    Transport transport() {
+        Transport t;
+        t.get = [this](const Request& req, const Transport::OnHead& on_head, const Transport::OnData& on_data,
+                       std::string& error) {
+            Step step;
+            {
+                std::lock_guard<std::mutex> lk(m);
+                requests.push_back(req);
+                times.push_back(std::chrono::steady_clock::now());
+                step = requests.size() <= steps.size() ? steps[requests.size() - 1] : otherwise;
+            }
+            if (!step) {
+                error = "Script ended";
+                return Fault::Fatal;
+            }
+            return step(req, on_head, on_data, error);
+        };
+        return t;
+    }
+
+    std::vector<Request> seen() {
+        std::lock_guard<std::mutex> lk(m);
+        return requests;
+    }
+};
+
+std::string body_of(std::size_t n) {
+    std::string b(n, '\0');
+    for (std::size_t i = 0; i < n; ++i) b[i] = (char)('a' + i * 7 % 26);
+    return b;
+}
+
+Step fail(const char* msg) {
+    return [msg](const Request&, const Transport::OnHead&, const Transport::OnData&, std::string& error) {
+        error = msg;
+        return Fault::Transient;
+    };
+}
+
+Step answer(int status, std::string retry_after = {}) {
+    return [status, retry_after](const Request&, const Transport::OnHead& on_head, const Transport::OnData&, std::string&) {
+        Head h;
+        h.status = status;
+        h.retry_after = retry_after;
+        return on_head(h) ? Fault::None : Fault::Stopped;
+    };
+}
+
+// Serve 'body' from the requested offset (206) or whole (200), stopping after 'send'
+// bytes; a short body ends cleanly, like a connection closed early. 'pace' slows chunks.
+Step serve(std::string body, std::size_t send = std::string::npos, bool ranges = true,
+           std::chrono::milliseconds pace = std::chrono::milliseconds(0)) {
+    return [=](const Request& req, const Transport::OnHead& on_head, const Transport::OnData& on_data, std::string&) {
+        const std::size_t from = ranges ? (std::size_t)req.offset : 0;
+        Head h;
+        h.status = from > 0 ? 206 : 200;
+        h.has_length = true;
+        h.content_length = body.size() - from;
+        if (!on_head(h)) return Fault::Stopped;
+        const std::size_t end = send == std::string::npos ? body.size() : (std::min)(body.size(), from + send);
+        for (std::size_t at = from; at < end; at += 100) {
+            if (pace.count() > 0) std::this_thread::sleep_for(pace);
+            if (!on_data(body.data() + at, (std::min)((std::size_t)100, end - at))) return Fault::Stopped;
+        }
+        return Fault::None;
+    };
+}
+
+retry::Policy fast_policy() {
+    retry::Policy p;
+    p.base_delay = retry::Millis{1};
+    p.max_delay = retry::Millis{2};
+    p.max_retry_after = retry::Millis{50};
+    return p;
+}
+
+std::string str(const fs::path& p) {
+    auto u = p.u8string();
+    return std::string(u.begin(), u.end());
+}
+
+std::string read(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+bool terminal(Status s) { return s == Status::Completed || s == Status::Failed || s == Status::Canceled; }
+
+Progress wait_for(Manager& m, Manager::Id id, const std::function<bool(const Progress&)>& pred) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    Progress p = m.query(id);
+    while (!pred(p) && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        p = m.query(id);
+    }
+    return p;
+}
+
+Progress wait_done(Manager& m, Manager::Id id) {
+    return wait_for(m, id, [](const Progress& p){ return terminal(p.status); });
+}
+
+Item item_for(const fs::path& dir, std::vector<std::string> urls) {
+    fs::create_directories(dir);
+    Item it;
+    it.title = "file.bin";
+    it.target_dir = str(dir);
+    it.urls = std::move(urls);
+    return it;
+}
+
+// Transport fault, 503 with Retry-After, 429, truncated body, then a Range resume
+void test_retry_and_resume(const fs::path& dir) {
+    const std::string body = body_of(1000);
+    Fake fake;
+    fake.steps = {fail("Connect failed"), answer(503, "120"), answer(429, "0"), serve(body, 400), serve(body)};
+    Manager m(fake.transport(), fast_policy());
+    const auto id = m.enqueue(item_for(dir, {"http://r1.test/file.bin"}));
+    const Progress p = wait_done(m, id);
+    CHECK(p.status == Status::Completed);
+    CHECK(p.bytes_done == 1000 && p.bytes_total == 1000);
+    CHECK(read(dir / "file.bin") == body);
+
+    const auto reqs = fake.seen();
+    CHECK(reqs.size() == 5);
+    if (reqs.size() == 5) {
+        for (int i = 0; i < 4; ++i) CHECK(reqs[(std::size_t)i].offset == 0);
+        CHECK(reqs[4].offset == 400);
+        // Retry-After (capped by the policy) was honoured before the third request
+        CHECK(fake.times[2] - fake.times[1] >= std::chrono::milliseconds(50));
+    }
+    // 429 is throttling, not a dead host: the breaker never opened
+    CHECK(!retry::breaker().is_open("r1.test"));
+}
+
+// A server ignoring Range restarts the file instead of appending to it
+void test_range_ignored(const fs::path& dir) {
+    const std::string body = body_of(800);
+    Fake fake;
+    fake.steps = {serve(body, 300), serve(body, std::string::npos, false)};
+    Manager m(fake.transport(), fast_policy());
+    const auto id = m.enqueue(item_for(dir, {"http://r2.test/file.bin"}));
+    CHECK(wait_done(m, id).status == Status::Completed);
+    CHECK(read(dir / "file.bin") == body);
+    const auto reqs = fake.seen();
+    CHECK(reqs.size() == 2 && reqs[1].offset == 300);
+}
+
+// A 404 moves on to the next mirror without retrying
+void test_next_mirror(const fs::path& dir) {
+    const std::string body = body_of(500);
+    Fake fake;
+    fake.steps = {answer(404), serve(body)};
+    Manager m(fake.transport(), fast_policy());
+    const auto id = m.enqueue(item_for(dir, {"http://m1.test/file.bin", "http://m2.test/file.bin"}));
+    CHECK(wait_done(m, id).status == Status::Completed);
+    CHECK(read(dir / "file.bin") == body);
+    const auto reqs = fake.seen();
+    CHECK(reqs.size() == 2 && reqs[0].url == "http://m1.test/file.bin" && reqs[1].url == "http://m2.test/file.bin");
+}
+
+// Persistent transport faults use up the attempts and open the host's breaker
+void test_exhausted(const fs::path& dir) {
+    Fake fake;
+    fake.steps = {fail("Stalled"), fail("Stalled"), fail("Stalled"), fail("Stalled"), fail("Stalled")};
+    Manager m(fake.transport(), fast_policy());
+    const auto id = m.enqueue(item_for(dir, {"http://dead.test/file.bin"}));
+    const Progress p = wait_done(m, id);
+    CHECK(p.status == Status::Failed);
+    // The breaker opens after three failures and stops further attempts
+    CHECK(fake.seen().size() == 3);
+    CHECK(p.message.find("Host unavailable") == 0);
+    CHECK(retry::breaker().is_open("dead.test"));
+}
+
+// Cancelling a half-open probe frees the probe slot without a verdict
+void test_cancel_releases_probe(const fs::path& dir) {
+    const std::string host = "probe.test";
+    const auto past = retry::Clock::now() - std::chrono::seconds(120);
+    for (int i = 0; i < 3; ++i) retry::breaker().on_failure(host, past);
+    CHECK(!retry::breaker().is_open(host)); // open window already over: next request probes
+
+    Fake fake;
+    fake.steps = {serve(body_of(100000), std::string::npos, true, std::chrono::milliseconds(1))};
+    Manager m(fake.transport(), fast_policy());
+    const auto id = m.enqueue(item_for(dir, {"http://" + host + "/file.bin"}));
+    CHECK(wait_for(m, id, [](const Progress& p){ return p.bytes_done > 0 || terminal(p.status); }).bytes_done > 0);
+    CHECK(!retry::breaker().allow(host)); // the download holds the probe
+    m.cancel(id);
+    const Progress p = wait_done(m, id);
+    CHECK(p.status == Status::Canceled);
+    CHECK(p.bytes_done < 100000);
+    std::error_code ec;
+    CHECK(fs::file_size(dir / "file.bin", ec) == p.bytes_done); // partial file kept for a resume
+    CHECK(retry::breaker().allow(host));
+    CHECK(!retry::breaker().allow(host));
+}
+
+// Shutting down mid-transfer is not a cancel: the next start resumes the item with Range
+void test_shutdown_resumes(const fs::path& dir) {
+    const std::string body = body_of(200000);
+    const std::string journal = str(dir / "downloads.journal");
+    fs::create_directories(dir);
+    Manager::Id id = 0;
+    std::uint64_t partial = 0;
+    {
+        Fake fake;
+        fake.steps = {serve(body, std::string::npos, true, std::chrono::milliseconds(1))};
+        auto m = std::make_unique<Manager>(fake.transport(), fast_policy());
+        CHECK(m->open_journal(journal) == 0);
+        id = m->enqueue(item_for(dir, {"http://slow.test/file.bin"}));
+        CHECK(wait_for(*m, id, [](const Progress& p){ return p.bytes_done >= 1000 || terminal(p.status); }).bytes_done >= 1000);
+        m.reset();
+        std::error_code ec;
+        partial = fs::file_size(dir / "file.bin", ec);
+        CHECK(partial > 0 && partial < body.size());
+    }
+
+    Fake fake;
+    fake.steps = {serve(body)};
+    Manager m(fake.transport(), fast_policy());
+    CHECK(m.open_journal(journal) == 1);
+    const Progress p = wait_done(m, id);
+    CHECK(p.status == Status::Completed);
+    CHECK(read(dir / "file.bin") == body);
+    const auto reqs = fake.seen();
+    CHECK(reqs.size() == 1 && reqs[0].offset == partial);
+}
+
+// Compaction keeps kKeepFinished finished items; dropped ones must not come back as blank
+// entries, neither at open nor through later progress and runtime compactions
+void test_history_cap(const fs::path& dir) {
+    const std::string journal = str(dir / "downloads.journal");
+    fs::create_directories(dir);
+    const std::size_t keep = app::downloads::journal::kKeepFinished;
+    auto run_batch = [&](std::size_t n, std::size_t expect_listed) {
+        Fake fake;
+        fake.otherwise = answer(404);
+        Manager m(fake.transport(), fast_policy());
+        CHECK(m.open_journal(journal) == 0);
+        CHECK(m.list().size() == expect_listed);
+        Manager::Id last = 0;
+        for (std::size_t i = 0; i < n; ++i) last = m.enqueue(item_for(dir, {"http://gone.test/" + std::to_string(i)}));
+        if (n > 0) CHECK(wait_done(m, last).status == Status::Failed);
+    };
+    run_batch(250, 0);
+    // Enough records to compact while running, with ids dropped at open still around
+    run_batch(1500, keep);
+    run_batch(0, keep);
+
+    Manager m(Transport{}, fast_policy());
+    CHECK(m.open_journal(journal) == 0);
+    const auto items = m.list();
+    CHECK(items.size() == keep);
+    for (const auto& kv : items) {
+        CHECK(!kv.second.title.empty() && kv.second.urls.size() == 1);
+        CHECK(m.query(kv.first).status == Status::Failed);
+    }
+    // The newest items are the ones kept
+    CHECK(!items.empty() && items.back().first == 1750);
+}
+
+} // namespace
+
+int main() {
+    std::error_code ec;
+    const fs::path base = fs::temp_directory_path() / "f95_downloads_test";
+    fs::remove_all(base, ec);
+    test_retry_and_resume(base / "retry");
+    test_range_ignored(base / "range");
+    test_next_mirror(base / "mirror");
+    test_exhausted(base / "dead");
+    test_cancel_releases_probe(base / "cancel");
+    test_shutdown_resumes(base / "shutdown");
+    test_history_cap(base / "history");
+    fs::remove_all(base, ec);
+    return check::result();
+}
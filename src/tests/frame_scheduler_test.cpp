@@ -0,0 +1,160 @@
+// Unit tests for app::frame_scheduler::Scheduler driven by a fake clock: when frames are
+// due after input, animation (set by the loop or reported by a view for one frame), hover
+// delays, cross-thread redraw requests and idling, and how the policy's frame cap and
+// idle timeout bound the waits.
+// Usage: f95_frame_scheduler_test
+
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+#include "app/frame_scheduler.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+using app::frame_scheduler::Policy;
+using app::frame_scheduler::Scheduler;
+
+bool near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+// Render one frame at 'now' on the fake clock
+void frame(Scheduler& s, double now) {
+    CHECK(s.due(now));
+    s.begin_frame(now);
+}
+
+void test_idle_and_input() {
+    Scheduler s(Policy{50.0, 1.0, 3});
+    double now = 100.0;
+    CHECK(s.due(now)); // the first frame is due immediately
+    frame(s, now);
+    CHECK(near(s.wait_time(now), 1.0));
+    CHECK(!s.due(now + 0.5));
+    CHECK(s.due(now + 1.0));
+
+    // Input: frames at the 50 fps cap, three settle frames, then idle again
+    now += 0.005;
+    s.on_input(now);
+    CHECK(near(s.wait_time(now), 0.015));
+    for (int i = 0; i < 3; ++i) {
+        now += 0.02;
+        frame(s, now);
+    }
+    CHECK(near(s.wait_time(now), 1.0));
+
+    // More input while settling restarts the count, it does not add up
+    s.on_input(now);
+    s.on_input(now);
+    now += 0.02;
+    frame(s, now);
+    now += 0.02;
+    frame(s, now);
+    CHECK(near(s.wait_time(now), 0.02));
+    now += 0.02;
+    frame(s, now);
+    CHECK(near(s.wait_time(now), 1.0));
+}
+
+void test_animating() {
+    Scheduler s(Policy{50.0, 1.0, 3});
+    double now = 5.0;
+    frame(s, now);
+    s.set_animating(true);
+    CHECK(near(s.wait_time(now), 0.02));
+    for (int i = 0; i < 10; ++i) {
+        now += 0.02;
+        frame(s, now);
+        CHECK(near(s.wait_time(now), 0.02));
+    }
+    s.set_animating(false);
+    CHECK(near(s.wait_time(now), 1.0));
+}
+
+void test_reported_animation() {
+    Scheduler s(Policy{50.0, 1.0, 3});
+    double now = 3.0;
+    frame(s, now);
+    // A view drew a moving progress line while building the frame
+    s.report_animation();
+    CHECK(near(s.wait_time(now), 0.02));
+    now += 0.02;
+    frame(s, now);
+    // Not reported again by the next frame: idle
+    CHECK(near(s.wait_time(now), 1.0));
+}
+
+void test_hover_delay() {
+    Scheduler s(Policy{50.0, 1.0, 3});
+    double now = 10.0;
+    frame(s, now);
+    s.on_input(now); // the pointer moved onto an item and stopped
+    int frames = 0;
+    while (frames < 100) {
+        now += 0.02;
+        frame(s, now);
+        ++frames;
+        s.hold_after_input(0.5); // the item is still hovered
+        if (near(s.wait_time(now), 1.0)) break;
+    }
+    // Frames keep coming until one starts after the delay, then the loop idles
+    CHECK(now >= 10.5);
+    CHECK(now < 10.5 + 0.02 + 1e-9);
+
+    // Unhovered: nothing holds the loop
+    now += 0.02;
+    s.on_input(now);
+    for (int i = 0; i < 3; ++i) {
+        now += 0.02;
+        frame(s, now);
+    }
+    CHECK(near(s.wait_time(now), 1.0));
+}
+
+void test_request_redraw() {
+    Scheduler s(Policy{100.0, 1.0, 3});
+    std::atomic<int> woken{0};
+    s.set_waker([&]{ ++woken; });
+    const double now = 7.0;
+    frame(s, now);
+    CHECK(near(s.wait_time(now), 1.0));
+
+    std::thread([&]{ s.request_redraw(); }).join();
+    CHECK(woken == 1);
+    CHECK(near(s.wait_time(now), 0.01));
+    frame(s, now + 0.01);
+    // Handled by that frame; idle again
+    CHECK(near(s.wait_time(now + 0.01), 1.0));
+
+    s.set_waker(nullptr);
+    s.request_redraw();
+    CHECK(woken == 1);
+    CHECK(near(s.wait_time(now + 0.01), 0.01));
+}
+
+void test_policy_limits() {
+    // No frame cap: input makes the next frame due at once
+    Scheduler uncapped(Policy{0.0, 1.0, 3});
+    frame(uncapped, 1.0);
+    uncapped.on_input(1.0);
+    CHECK(uncapped.due(1.0));
+    CHECK(near(uncapped.wait_time(1.0), 0.0));
+
+    // No idle timeout: idle frames are still limited by the cap
+    Scheduler busy(Policy{60.0, 0.0, 3});
+    frame(busy, 1.0);
+    CHECK(near(busy.wait_time(1.0), 1.0 / 60.0));
+    CHECK(!busy.due(1.0));
+}
+
+} // namespace
+
+int main() {
+    test_idle_and_input();
+    test_animating();
+    test_reported_animation();
+    test_hover_delay();
+    test_request_redraw();
+    test_policy_limits();
+    return check::result();
+}
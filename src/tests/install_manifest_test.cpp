@@ -0,0 +1,94 @@
+// Unit tests for app::install: changed-files-only updates, and that an update deletes
+// only files a recorded manifest lists. Works in a scratch folder under the temp dir.
+// Usage: f95_install_manifest_test
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "app/install_manifest.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void write(const fs::path& p, const std::string& data) {
+    fs::create_directories(p.parent_path());
+    std::ofstream(p, std::ios::binary | std::ios::trunc) << data;
+}
+
+std::string read(const fs::path& p) {
+    std::ifstream in(p, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+std::string str(const fs::path& p) {
+    auto u = p.u8string();
+    return std::string(u.begin(), u.end());
+}
+
+void test_without_manifest(const fs::path& base) {
+    const fs::path game = base / "legacy", staged = base / "legacy_new";
+    write(game / "game.exe", "v1");
+    write(game / "data.pak", "same");
+    write(game / "config.ini", "user settings");
+    write(game / "mods/mod.rpy", "user mod");
+    write(game / "saves/1.save", "progress");
+    write(staged / "game.exe", "v2");
+    write(staged / "data.pak", "same");
+    write(staged / "saves/1.save", "shipped");
+
+    const auto r = app::install::apply_update(str(staged), str(game));
+    CHECK(r.ok);
+    CHECK(r.removed == 0);
+    CHECK(read(game / "game.exe") == "v2");
+    CHECK(read(game / "config.ini") == "user settings");
+    CHECK(read(game / "mods/mod.rpy") == "user mod");
+    CHECK(read(game / "saves/1.save") == "progress");
+
+    // Only files of the new tree are recorded
+    app::install::Manifest m;
+    CHECK(app::install::load_manifest(str(game), m));
+    CHECK(m.count("game.exe") == 1 && m.count("data.pak") == 1);
+    CHECK(m.count("config.ini") == 0 && m.count("mods/mod.rpy") == 0);
+}
+
+void test_with_manifest(const fs::path& base) {
+    const fs::path game = base / "tracked", staged = base / "tracked_new";
+    write(game / "game.exe", "v1");
+    write(game / "old/dropped.dat", "gone next version");
+    write(game / "keep.dat", "unchanged");
+    write(game / "saves/1.save", "progress");
+    CHECK(app::install::record_install(str(game)));
+    write(game / "user.txt", "added after install");
+
+    write(staged / "game.exe", "v2");
+    fs::copy_file(game / "keep.dat", staged / "keep.dat");
+    fs::last_write_time(staged / "keep.dat", fs::last_write_time(game / "keep.dat"));
+
+    const auto r = app::install::apply_update(str(staged), str(game));
+    CHECK(r.ok);
+    CHECK(r.written == 1);
+    CHECK(r.unchanged == 1);
+    CHECK(r.removed == 1);
+    CHECK(read(game / "game.exe") == "v2");
+    CHECK(!fs::exists(game / "old"));
+    CHECK(read(game / "user.txt") == "added after install");
+    CHECK(read(game / "saves/1.save") == "progress");
+}
+
+} // namespace
+
+int main() {
+    std::error_code ec;
+    const fs::path base = fs::temp_directory_path() / "f95_install_manifest_test";
+    fs::remove_all(base, ec);
+    test_without_manifest(base);
+    test_with_manifest(base);
+    fs::remove_all(base, ec);
+    return check::result();
+}
@@ -0,0 +1,122 @@
+// Unit tests for app::retry (backoff, Retry-After, circuit breaker) and the download
+// Content-Length parser. Time is passed in explicitly, so nothing sleeps.
+// Usage: f95_retry_test
+
+#include <string>
+#include <ctime>
+
+#include "app/retry.hpp"
+#include "app/downloads.hpp"
+#include "tests/check.hpp"
+
+namespace {
+
+using namespace app::retry;
+
+void test_backoff() {
+    Policy p;
+    p.base_delay = Millis{100};
+    p.max_delay = Millis{1000};
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        const long long cap = (std::min)(1000LL, 100LL << attempt);
+        for (int i = 0; i < 200; ++i) {
+            const Millis d = backoff_delay(attempt, p);
+            CHECK(d.count() >= 0 && d.count() <= cap);
+        }
+    }
+    // Huge and negative attempts stay within bounds
+    CHECK(backoff_delay(1000, p).count() <= 1000);
+    CHECK(backoff_delay(-5, p).count() <= 100);
+    p.base_delay = Millis{0};
+    CHECK(backoff_delay(3, p).count() == 0);
+}
+
+void test_retryable_status() {
+    CHECK(is_retryable_status(429));
+    CHECK(is_retryable_status(503));
+    CHECK(!is_retryable_status(404));
+    CHECK(!is_retryable_status(200));
+}
+
+void test_retry_after() {
+    Millis out{0};
+    CHECK(parse_retry_after(" 120 ", out) && out == Millis{120000});
+    CHECK(parse_retry_after("99999999999", out) && out == default_policy().max_retry_after);
+    CHECK(!parse_retry_after("", out));
+    CHECK(!parse_retry_after("soon", out));
+    // 2015-10-21 07:28:00 UTC is 1445412480
+    const std::time_t now = 1445412480 - 30;
+    CHECK(parse_retry_after("Wed, 21 Oct 2015 07:28:00 GMT", out, now) && out == Millis{30000});
+    CHECK(parse_retry_after("Wed, 21 Oct 2015 07:28:00 GMT", out, now + 60) && out == Millis{0});
+    CHECK(!parse_retry_after("Wed, 21 Foo 2015 07:28:00 GMT", out, now));
+}
+
+void test_breaker() {
+    CircuitBreaker::Config cfg;
+    cfg.failure_threshold = 2;
+    cfg.open_duration = Millis{1000};
+    cfg.max_open_duration = Millis{3000};
+    CircuitBreaker cb(cfg);
+    const Clock::time_point t0{};
+    const std::string h = "example.com";
+
+    CHECK(cb.allow(h, t0));
+    cb.on_failure(h, t0);
+    CHECK(cb.allow(h, t0));            // below threshold
+    cb.on_failure(h, t0);
+    CHECK(cb.is_open(h, t0));
+    CHECK(!cb.allow(h, t0 + Millis{999}));
+
+    // Half-open: exactly one probe
+    CHECK(cb.allow(h, t0 + Millis{1000}));
+    CHECK(!cb.allow(h, t0 + Millis{1000}));
+
+    // A failed probe re-opens for twice as long
+    cb.on_failure(h, t0 + Millis{1000});
+    CHECK(!cb.allow(h, t0 + Millis{2999}));
+    CHECK(cb.allow(h, t0 + Millis{3000}));
+
+    // A cancelled probe frees the slot without a verdict
+    cb.release(h);
+    CHECK(cb.allow(h, t0 + Millis{3000}));
+    CHECK(!cb.allow(h, t0 + Millis{3000}));
+
+    // Re-open duration is capped
+    cb.on_failure(h, t0 + Millis{3000});
+    cb.allow(h, t0 + Millis{6000});
+    cb.on_failure(h, t0 + Millis{6000});
+    CHECK(cb.allow(h, t0 + Millis{9000}));
+
+    // Success closes the circuit
+    cb.on_success(h);
+    CHECK(!cb.is_open(h, t0 + Millis{9000}));
+    CHECK(cb.allow(h, t0 + Millis{9000}));
+    CHECK(cb.allow(h, t0 + Millis{9000}));
+
+    // Release on a closed host is a no-op
+    cb.release("other.org");
+    CHECK(cb.allow("other.org", t0));
+}
+
+void test_content_length() {
+    using app::downloads::detail::parse_content_length;
+    std::uint64_t n = 0;
+    CHECK(parse_content_length("0", n) && n == 0);
+    CHECK(parse_content_length(" 4294967296 ", n) && n == 4294967296ull); // 4 GiB, past DWORD
+    CHECK(parse_content_length("17179869184", n) && n == 17179869184ull);
+    CHECK(!parse_content_length("", n));
+    CHECK(!parse_content_length("-1", n));
+    CHECK(!parse_content_length("12a", n));
+    CHECK(!parse_content_length("99999999999999999999", n));
+}
+
+} // namespace
+
+int main() {
+    test_backoff();
+    test_retryable_status();
+    test_retry_after();
+    test_breaker();
+    test_content_length();
+    return check::result();
+}
@@ -0,0 +1,65 @@
+#pragma once
+// Row layout for the virtualized cards grid.
+// Items are laid out in rows of 'cols' cards; row_top holds the prefix sum of row heights
+// (plus spacing), so the rows intersecting any vertical range are found by binary search
+// and only those are emitted. The layout is rebuilt only when its inputs change.
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+namespace views {
+namespace cards {
+namespace grid_layout {
+
+struct Key {
+    std::uint64_t items = 0;     // caller's generation of the item list, bumped on every change
+    std::size_t count = 0;
+    int cols = 0;
+    float card_width = 0.0f;
+    float spacing = 0.0f;
+    std::uint64_t version = 0;   // bumped by the caller when card heights may change
+
+    bool operator==(const Key&) const = default;
+};
+
+struct Layout {
+    Key key;
+    std::vector<float> row_top; // rows() + 1 entries; row_top.back() = total height
+
+    int rows() const { return row_top.empty() ? 0 : (int)row_top.size() - 1; }
+    float height() const { return row_top.empty() ? 0.0f : row_top.back(); }
+    float row_height(int r) const { return row_top[(std::size_t)r + 1] - row_top[(std::size_t)r]; }
+
+    // First and one-past-last row intersecting [y0, y1) (content coordinates)
+    std::pair<int, int> rows_in(float y0, float y1) const {
+        if (rows() == 0 || y1 <= y0) return {0, 0};
+        // Row r spans [row_top[r], row_top[r + 1])
+        const int first = (int)(std::upper_bound(row_top.begin(), row_top.end() - 1, y0) - row_top.begin()) - 1;
+        const int last = (int)(std::lower_bound(row_top.begin(), row_top.end() - 1, y1) - row_top.begin());
+        return {(std::max)(first, 0), (std::min)(last, rows())};
+    }
+};
+
+// Rebuild 'l' for 'key' if it changed. card_height(i) gives the height of item i; a row
+// is as tall as its tallest card, and rows are separated by key.spacing.
+inline bool update(Layout& l, const Key& key, const std::function<float(std::size_t)>& card_height) {
+    if (l.key == key && !l.row_top.empty()) return false;
+    l.key = key;
+    const int cols = (std::max)(key.cols, 1);
+    const std::size_t rows = (key.count + (std::size_t)cols - 1) / (std::size_t)cols;
+    l.row_top.assign(rows + 1, 0.0f);
+    for (std::size_t r = 0; r < rows; ++r) {
+        float h = 0.0f;
+        const std::size_t end = (std::min)(key.count, (r + 1) * (std::size_t)cols);
+        for (std::size_t i = r * (std::size_t)cols; i < end; ++i) h = (std::max)(h, card_height(i));
+        l.row_top[r + 1] = l.row_top[r] + h + (r + 1 < rows ? key.spacing : 0.0f);
+    }
+    return true;
+}
+
+} // namespace grid_layout
+} // namespace cards
+} // namespace views
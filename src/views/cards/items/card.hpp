@@ -1,24 +1,155 @@
 #pragma once
 // Port target: src/views/cards/items/card.rs
 // Purpose: Model/logic for a single card in the cards view.
+// A Card is a game resolved against the tag catalog once, at ingest: tag and prefix
+// names become dense ids (tags/index.hpp) and the engine an id. Warning settings are
+// compiled into the same bitsets, so a card's warnings are one AND + popcount.
+// Cards are kept by the game's ingest id (GameInfo::id), at most kMaxCards of them.
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <map>
+#include <algorithm>
+
+#include "../../../parser/parser.hpp"
+#include "../../../app/settings/settings.hpp"
+#include "../../../tags/index.hpp"
 
 namespace views {
 namespace cards {
 namespace items {
 
+inline constexpr std::size_t kMaxCards = 16384;
+
 struct Card {
-    // std::string title;
-    // std::string subtitle;
-    // std::vector<std::string> tags;
-    // std::string cover_path;
-    // bool installed = false;
+    tags::Bitset tags;     // tag ids of the game's tags
+    tags::Bitset prefixes; // prefix ids named by a tag or in the title
+    int engine = -1;       // prefix id of the engine, -1 if unknown
+};
+
+// Warning settings compiled against an index
+struct WarnSet {
+    tags::Bitset tags;
+    tags::Bitset prefixes;
+};
+
+// Resolve a game against 'ix' (unknown tag names are interned).
+// Engine: the first Engine prefix named by a tag, else the first one in the title.
+inline Card make_card(const parser::GameInfo& gi, tags::Index& ix) {
+    Card c;
+    for (const auto& t : gi.meta.tags) {
+        c.tags.set(ix.intern_tag(t));
+        if (const auto* ids = ix.prefix_ids(t)) {
+            for (int id : *ids) c.prefixes.set(id);
+        }
+    }
+    const std::string title = tags::fold(gi.meta.title);
+    for (int id = 0; id < (int)ix.prefix_folded.size(); ++id) {
+        const std::string& p = ix.prefix_folded[(std::size_t)id];
+        if (!p.empty() && title.find(p) != std::string::npos) c.prefixes.set(id);
+    }
+    for (int id : ix.engine_prefixes) {
+        const int tid = ix.tag_id(ix.prefix_folded[(std::size_t)id]);
+        if (tid >= 0 && c.tags.test(tid)) {
+            c.engine = id;
+            break;
+        }
+    }
+    if (c.engine < 0) {
+        for (int id : ix.engine_prefixes) {
+            const std::string& p = ix.prefix_folded[(std::size_t)id];
+            if (!p.empty() && title.find(p) != std::string::npos) {
+                c.engine = id;
+                break;
+            }
+        }
+    }
+    return c;
+}
+
+inline WarnSet compile_warnings(const app::settings::Config& cfg, tags::Index& ix) {
+    WarnSet w;
+    for (const auto& t : cfg.warn_tags) w.tags.set(ix.intern_tag(t));
+    for (const auto& p : cfg.warn_prefixes) {
+        if (const auto* ids = ix.prefix_ids(p)) {
+            for (int id : *ids) w.prefixes.set(id);
+        }
+    }
+    return w;
+}
+
+inline int warn_count(const Card& c, const WarnSet& w) {
+    return c.tags.and_count(w.tags) + c.prefixes.and_count(w.prefixes);
+}
+
+namespace detail {
+inline std::uint64_t fnv(std::uint64_t h, const std::string& s) {
+    for (unsigned char ch : s) h = (h ^ ch) * 1099511628211ull;
+    return (h ^ 0xFFu) * 1099511628211ull;
+}
+
+struct Cards {
+    std::map<std::uint64_t, Card> by_id; // ordered by id: begin() is the oldest ingest
+    std::uint64_t next_id = 0;
+    std::uint64_t generation = 0;
 };
 
-// Placeholder API:
-// void render(const Card& c);
+// UI thread only. Cleared when the index changes; cards are then resolved again on use.
+inline Cards& cards(const tags::Index& ix) {
+    static Cards c;
+    if (c.generation != ix.generation) {
+        c.by_id.clear();
+        c.generation = ix.generation;
+    }
+    return c;
+}
+
+// Store a card, dropping the oldest ingests first when full
+inline const Card& insert(Cards& c, std::uint64_t id, Card card) {
+    while (c.by_id.size() >= kMaxCards) c.by_id.erase(c.by_id.begin());
+    return c.by_id[id] = std::move(card);
+}
+} // namespace detail
+
+// Resolve 'gi' once when it enters the app: gives it an id (if it has none) and stores
+// its card. Copies of the game share the id and the card. UI thread only.
+inline void ingest(parser::GameInfo& gi, tags::Index& ix) {
+    detail::Cards& c = detail::cards(ix);
+    if (gi.id == 0) gi.id = ++c.next_id;
+    else c.next_id = (std::max)(c.next_id, gi.id);
+    detail::insert(c, gi.id, make_card(gi, ix));
+}
+
+// Card of an ingested game: a lookup by id, resolved again if it was trimmed or the
+// index changed. A game that was never ingested is resolved on every call into a scratch
+// card, valid until the next call. UI thread only.
+inline const Card& card_for(const parser::GameInfo& gi, tags::Index& ix) {
+    if (gi.id == 0) {
+        static Card scratch;
+        scratch = make_card(gi, ix);
+        return scratch;
+    }
+    detail::Cards& c = detail::cards(ix);
+    auto it = c.by_id.find(gi.id);
+    if (it != c.by_id.end()) return it->second;
+    return detail::insert(c, gi.id, make_card(gi, ix));
+}
+
+// Warning set for 'cfg', recompiled when the warning lists or the index change.
+inline const WarnSet& warn_set(const app::settings::Config& cfg, tags::Index& ix) {
+    static WarnSet ws;
+    static std::uint64_t key = 0;
+    std::uint64_t k = detail::fnv(1469598103934665603ull, std::to_string(ix.generation));
+    for (const auto& t : cfg.warn_tags) k = detail::fnv(k, t);
+    k = detail::fnv(k, "|");
+    for (const auto& p : cfg.warn_prefixes) k = detail::fnv(k, p);
+    if (k != key) {
+        ws = compile_warnings(cfg, ix);
+        key = k;
+    }
+    return ws;
+}
 
 } // namespace items
 } // namespace cards
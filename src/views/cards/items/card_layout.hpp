@@ -0,0 +1,199 @@
+#pragma once
+// Purpose: Per-card layout cache (title line breaks, chip widths and wraps, badge text
+// sizes, engine/warning lookups, total card height).
+// Entries are keyed by the card's content, the inner width, the font and the warning
+// settings, so they are computed once and reused every frame until one of those changes.
+// The virtualized grid reads card heights from here to size its rows.
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
+
+#include "../../../../vendor/imgui/imgui.h"
+#include "../../../parser/parser.hpp"
+#include "../../../app/settings/settings.hpp"
+#include "../../../tags/mod.hpp"
+#include "../../../ui_constants.hpp"
+#include "cover_helpers.hpp"
+
+namespace views {
+namespace cards {
+namespace items {
+namespace card_layout {
+
+inline constexpr std::size_t kMaxEntries = 65536; // cache is dropped wholesale beyond this
+inline constexpr float kChipPadX = 8.0f;          // tags_panel::chip() frame padding
+inline constexpr float kChipPadY = 4.0f;
+
+struct Layout {
+    std::string title;             // with line breaks inserted for the inner width
+    std::vector<float> chip_w;     // per tag, including chip padding
+    std::vector<bool> chip_break;  // tag i starts a new chip line
+    int chip_rows = 0;
+    std::string version;           // badge text ("v?" when unknown)
+    ImVec2 version_size;
+    std::string engine;            // empty if not resolvable
+    ImVec2 engine_size;
+    int warn_count = 0;
+    std::string warn_label;        // "!N"
+    ImVec2 warn_size;
+    float height = 0.0f;           // whole card, including window padding
+};
+
+namespace detail {
+struct Fnv {
+    std::uint64_t h = 1469598103934665603ull;
+    void bytes(const void* p, std::size_t n) {
+        const auto* b = (const unsigned char*)p;
+        for (std::size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 1099511628211ull;
+    }
+    void str(const std::string& s) { bytes(s.data(), s.size()); bytes("\0", 1); }
+    template <class T> void pod(const T& v) { bytes(&v, sizeof(v)); }
+};
+
+inline std::unordered_map<std::uint64_t, Layout>& cache() {
+    static std::unordered_map<std::uint64_t, Layout> c;
+    return c;
+}
+
+// Greedy word wrap of 'text' to 'width'; words longer than a line are broken by character
+inline std::string wrap(const std::string& text, float width) {
+    std::string out, line;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        std::size_t j = text.find(' ', i);
+        if (j == std::string::npos) j = text.size();
+        const std::string word = text.substr(i, j - i);
+        const std::string candidate = line.empty() ? word : line + " " + word;
+        if (line.empty() || ImGui::CalcTextSize(candidate.c_str()).x <= width) {
+            line = candidate;
+        } else {
+            out += line + "\n";
+            line = word;
+        }
+        // Hard-break a single overlong word
+        while (ImGui::CalcTextSize(line.c_str()).x > width && line.size() > 1) {
+            std::size_t k = line.size() - 1;
+            while (k > 1 && ImGui::CalcTextSize(line.substr(0, k).c_str()).x > width) --k;
+            out += line.substr(0, k) + "\n";
+            line = line.substr(k);
+        }
+        i = j + 1;
+    }
+    return out + line;
+}
+} // namespace detail
+
+namespace detail {
+inline void hash_context(Fnv& f, float inner_w, const app::settings::Config* cfg, const tags::Catalog* cat) {
+    f.pod(inner_w);
+    f.pod((const void*)ImGui::GetFont());
+    f.pod(ImGui::GetFontSize());
+    f.pod((const void*)cfg);
+    if (cfg) {
+        for (const auto& w : cfg->warn_tags) f.str(w);
+        f.bytes("|", 1);
+        for (const auto& w : cfg->warn_prefixes) f.str(w);
+    }
+    f.pod((const void*)cat);
+    if (cat) f.pod(cat->games.size() + cat->comics.size() + cat->animations.size() + cat->assets.size());
+}
+} // namespace detail
+
+// Identity of everything but the card itself (width, font, warning settings, catalog)
+inline std::uint64_t context_key(float inner_w, const app::settings::Config* cfg, const tags::Catalog* cat) {
+    detail::Fnv f;
+    detail::hash_context(f, inner_w, cfg, cat);
+    return f.h;
+}
+
+// Identity of everything a card's layout depends on
+inline std::uint64_t key(const parser::GameInfo& gi, float inner_w, const app::settings::Config* cfg, const tags::Catalog* cat) {
+    detail::Fnv f;
+    f.str(gi.meta.title);
+    f.str(gi.meta.author);
+    f.str(gi.meta.version);
+    for (const auto& t : gi.meta.tags) f.str(t);
+    f.pod(gi.links.size());
+    for (const auto& l : gi.links) f.str(l.url);
+    detail::hash_context(f, inner_w, cfg, cat);
+    return f.h;
+}
+
+inline Layout build(const parser::GameInfo& gi, float inner_w, const app::settings::Config* cfg, const tags::Catalog* cat) {
+    Layout l;
+    const float sp = (float)ui_constants::kSpacing;
+    const float line = ImGui::GetTextLineHeight();
+
+    l.title = detail::wrap(gi.meta.title.empty() ? "(no title)" : gi.meta.title, inner_w);
+    const int title_lines = 1 + (int)std::count(l.title.begin(), l.title.end(), '\n');
+
+    // Chips: same wrapping rule as tags_panel::render_chips
+    const float item_sp = sp;
+    float x = 0.0f;
+    for (std::size_t i = 0; i < gi.meta.tags.size(); ++i) {
+        const float w = ImGui::CalcTextSize(gi.meta.tags[i].c_str()).x + 2.0f * kChipPadX;
+        const bool brk = i != 0 && x + w > inner_w;
+        if (brk || i == 0) {
+            ++l.chip_rows;
+            x = 0.0f;
+        }
+        l.chip_w.push_back(w);
+        l.chip_break.push_back(brk);
+        x += w + item_sp;
+    }
+
+    l.version = gi.meta.version.empty() ? "v?" : gi.meta.version;
+    l.version_size = ImGui::CalcTextSize(l.version.c_str());
+    if (cat) {
+        l.engine = cover_helpers::resolve_engine_name(gi, *cat);
+        if (!l.engine.empty()) l.engine_size = ImGui::CalcTextSize(l.engine.c_str());
+    }
+    if (cfg && cat) {
+        l.warn_count = cover_helpers::warning_count(gi, *cfg, *cat);
+    } else {
+        l.warn_count = (int)gi.meta.tags.size() > 8 ? 1 : 0;
+    }
+    if (l.warn_count > 0) {
+        l.warn_label = "!" + std::to_string(l.warn_count);
+        l.warn_size = ImGui::CalcTextSize(l.warn_label.c_str());
+    }
+
+    // Height: items of draw_thread_card, each followed by item spacing, plus window padding
+    float h = inner_w * 9.0f / 16.0f + sp;            // cover
+    h += line * (float)title_lines + sp;              // title
+    if (!gi.meta.author.empty()) h += line + sp;      // author
+    h += 6.0f + sp;                                   // gap
+    h += line + sp;                                   // meta row
+    if (!gi.meta.tags.empty()) {
+        h += 2.0f + sp;                               // chip top gap
+        h += (float)l.chip_rows * (line + 2.0f * kChipPadY + sp);
+    }
+    if (!gi.links.empty()) {
+        h += 6.0f + sp;                               // gap
+        h += 1.0f + sp;                               // separator
+        h += (line + sp) * (float)(1 + gi.links.size()); // "Links:" + one line each
+    }
+    h -= sp; // no spacing after the last item
+    l.height = h + 2.0f * ImGui::GetStyle().WindowPadding.y;
+    return l;
+}
+
+// Cached layout for a card; valid until the next call that has to build a new one
+// after the cache outgrew kMaxEntries.
+inline const Layout& get(const parser::GameInfo& gi, float inner_w, const app::settings::Config* cfg, const tags::Catalog* cat) {
+    auto& c = detail::cache();
+    const std::uint64_t k = key(gi, inner_w, cfg, cat);
+    auto it = c.find(k);
+    if (it != c.end()) return it->second;
+    if (c.size() >= kMaxEntries) c.clear();
+    return c.emplace(k, build(gi, inner_w, cfg, cat)).first->second;
+}
+
+} // namespace card_layout
+} // namespace items
+} // namespace cards
+} // namespace views
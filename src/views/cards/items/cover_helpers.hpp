@@ -11,6 +11,8 @@
 #include "../../../parser/parser.hpp"
 #include "../../../app/settings/settings.hpp"
 #include "../../../tags/mod.hpp"
+#include "../../../tags/index.hpp"
+#include "card.hpp"
 
 namespace views {
 namespace cards {
@@ -45,81 +47,36 @@ inline std::string unescape_html_entities(const std::string& s) {
     return out;
 }
 
-// Try to resolve engine name by matching known Engine prefixes against thread tags/title.
-// This is a heuristic because C++ port does not carry explicit prefix ids like Rust.
+// Engine name of a game: the Engine prefix resolved when the game was ingested
+// (card.hpp), empty if none.
 inline std::string resolve_engine_name(const ::parser::GameInfo& gi, const tags::Catalog& cat) {
-    // Locate "Engine" group within games prefixes
-    const tags::Group* engine_group = nullptr;
-    for (const auto& g : cat.games) {
-        if (iequals(g.name, "Engine")) { engine_group = &g; break; }
-    }
-    if (!engine_group) return std::string();
-
-    // 1) Match by tag equality
-    for (const auto& p : engine_group->prefixes) {
-        for (const auto& t : gi.meta.tags) {
-            if (iequals(p.name, t)) {
-                return unescape_html_entities(p.name);
-            }
-        }
-    }
-    // 2) Fallback: substring in title
-    for (const auto& p : engine_group->prefixes) {
-        if (icontains(gi.meta.title, p.name)) {
-            return unescape_html_entities(p.name);
-        }
-    }
-    return std::string();
+    tags::Index& ix = tags::index_for(cat);
+    const Card& c = card_for(gi, ix);
+    return c.engine < 0 ? std::string() : ix.prefix_names[(std::size_t)c.engine];
 }
 
-// Collect warnings (tag and prefix names) based on user settings.
-// - Tags: name-based intersection with gi.meta.tags
-// - Prefixes: name-based match (appears in tags or title) against configured warn_prefixes
+// Warning tag and prefix names of a game under the user's settings: the ingested
+// card's tag/prefix bits ANDed with the compiled warning sets.
 inline std::pair<std::vector<std::string>, std::vector<std::string>>
 collect_warnings(const ::parser::GameInfo& gi,
                  const app::settings::Config& cfg,
                  const tags::Catalog& cat) {
+    tags::Index& ix = tags::index_for(cat);
+    const Card& c = card_for(gi, ix);
+    const WarnSet& w = warn_set(cfg, ix);
     std::vector<std::string> tag_names;
     std::vector<std::string> pref_names;
-
-    // Tags: compare by names (case-insensitive)
-    for (const auto& warn : cfg.warn_tags) {
-        for (const auto& t : gi.meta.tags) {
-            if (iequals(warn, t)) {
-                tag_names.push_back(t);
-                break;
-            }
-        }
-    }
-
-    // Build a flat list of all prefixes (games, comics, animations, assets)
-    auto scan_groups = [&](const std::vector<tags::Group>& groups) {
-        for (const auto& g : groups) {
-            for (const auto& p : g.prefixes) {
-                // If this prefix is configured as warned, check presence
-                bool configured = std::any_of(cfg.warn_prefixes.begin(), cfg.warn_prefixes.end(),
-                                              [&](const std::string& w){ return iequals(w, p.name); });
-                if (!configured) continue;
-
-                // If present in tags list or in title, add
-                bool present = std::any_of(gi.meta.tags.begin(), gi.meta.tags.end(),
-                                           [&](const std::string& t){ return iequals(t, p.name); })
-                               || icontains(gi.meta.title, p.name);
-
-                if (present) {
-                    pref_names.push_back(unescape_html_entities(p.name));
-                }
-            }
-        }
-    };
-    scan_groups(cat.games);
-    scan_groups(cat.comics);
-    scan_groups(cat.animations);
-    scan_groups(cat.assets);
-
+    c.tags.for_each_and(w.tags, [&](int id){ tag_names.push_back(ix.tag_names[(std::size_t)id]); });
+    c.prefixes.for_each_and(w.prefixes, [&](int id){ pref_names.push_back(ix.prefix_names[(std::size_t)id]); });
     return {tag_names, pref_names};
 }
 
+// Number of warnings (same as the two lists of collect_warnings combined)
+inline int warning_count(const ::parser::GameInfo& gi, const app::settings::Config& cfg, const tags::Catalog& cat) {
+    tags::Index& ix = tags::index_for(cat);
+    return warn_count(card_for(gi, ix), warn_set(cfg, ix));
+}
+
 } // namespace cover_helpers
 } // namespace items
 } // namespace cards
@@ -0,0 +1,91 @@
+#pragma once
+// Visibility-driven cover loading for the cards grid.
+// Each frame the grid records its viewport (screen-space top/bottom) and a smoothed
+// scroll velocity. A cover is requested only if it is visible or inside the prefetch
+// window: kPrefetchBase viewports around the view, extended in the scroll direction by
+// velocity * kLookaheadSec (capped at kPrefetchMax viewports). Requests carry a priority
+// (0 = visible, otherwise pixels from the viewport), so the cover pipeline decodes the
+// nearest covers first and drops queued ones that left the window.
+
+#include <cmath>
+#include <unordered_map>
+#include <algorithm>
+
+#include "../../../../vendor/imgui/imgui.h"
+
+namespace views {
+namespace cards {
+namespace items {
+namespace cover_loader {
+
+inline constexpr float kPrefetchBase = 0.5f;   // viewports prefetched on both sides when idle
+inline constexpr float kPrefetchMax = 4.0f;    // max viewports ahead while scrolling fast
+inline constexpr float kLookaheadSec = 0.75f;  // how far ahead velocity is projected
+inline constexpr float kVelocitySmoothing = 0.2f;
+
+// Not requested: outside the prefetch window
+inline constexpr int kSkip = -1;
+
+struct Viewport {
+    float top = 0.0f;       // screen-space y of the visible area
+    float bottom = 0.0f;
+    float velocity = 0.0f;  // content pixels per second; > 0 = scrolling down
+};
+
+namespace detail {
+struct Tracker {
+    float scroll = 0.0f;
+    double time = 0.0;
+    float velocity = 0.0f;
+    bool init = false;
+};
+
+inline std::unordered_map<ImGuiID, Tracker>& trackers() {
+    static std::unordered_map<ImGuiID, Tracker> t;
+    return t;
+}
+} // namespace detail
+
+// Capture the current window's viewport and update its scroll velocity. Call once per
+// frame in the scrolling window, before drawing its cards.
+inline Viewport track_current_window() {
+    Viewport vp;
+    const ImVec2 pos = ImGui::GetWindowPos();
+    vp.top = pos.y;
+    vp.bottom = pos.y + ImGui::GetWindowHeight();
+
+    auto& t = detail::trackers()[ImGui::GetID("##cover_loader")];
+    const float scroll = ImGui::GetScrollY();
+    const double now = ImGui::GetTime();
+    if (t.init && now > t.time) {
+        const float instant = (float)((scroll - t.scroll) / (now - t.time));
+        t.velocity += (instant - t.velocity) * kVelocitySmoothing;
+        if (std::fabs(t.velocity) < 1.0f) t.velocity = 0.0f;
+    }
+    t.scroll = scroll;
+    t.time = now;
+    t.init = true;
+    vp.velocity = t.velocity;
+    return vp;
+}
+
+// Request priority for an item spanning [y0, y1] in screen space: 0 if visible,
+// distance in pixels if inside the prefetch window, kSkip otherwise.
+inline int priority(const Viewport& vp, float y0, float y1) {
+    if (y1 >= vp.top && y0 <= vp.bottom) return 0;
+    const float h = (std::max)(vp.bottom - vp.top, 1.0f);
+    const float ahead = (std::min)(kPrefetchBase * h + std::fabs(vp.velocity) * kLookaheadSec, kPrefetchMax * h);
+    const float below = vp.velocity >= 0.0f ? ahead : kPrefetchBase * h;
+    const float above = vp.velocity < 0.0f ? ahead : kPrefetchBase * h;
+    if (y0 > vp.bottom) {
+        const float d = y0 - vp.bottom;
+        return d <= below ? 1 + (int)d : kSkip;
+    }
+    const float d = vp.top - y1;
+    return d <= above ? 1 + (int)d : kSkip;
+}
+
+} // namespace cover_loader
+} // namespace items
+} // namespace cards
+} // namespace views
@@ -27,11 +27,38 @@ inline void chip(const std::string& text) {
     ImGui::PopStyleVar(2);
 }
 
+// Same look as chip() for a label whose width (including padding) is already known:
+// drawn directly instead of as a Button, so the label is not measured again.
+inline void chip_sized(const std::string& text, float width) {
+    const float h = ImGui::GetTextLineHeight() + 8.0f;
+    ImGui::InvisibleButton("##chip", ImVec2(width, h)); // callers push a unique id
+    const ImVec2 p0 = ImGui::GetItemRectMin(), p1 = ImGui::GetItemRectMax();
+    const ImU32 bg = ImGui::IsItemActive()    ? IM_COL32(51, 51, 64, 255)
+                   : ImGui::IsItemHovered()   ? IM_COL32(77, 77, 89, 255)
+                                              : IM_COL32(64, 64, 77, 255);
+    ImDrawList* dl = ImGui::GetWindowDrawList();
+    dl->AddRectFilled(p0, p1, bg, 6.0f);
+    dl->AddText(ImVec2(p0.x + 8.0f, p0.y + 4.0f), IM_COL32(217, 217, 230, 255), text.c_str(), text.c_str() + text.size());
+}
+
 // Render a list of tags as chips with simple wrapping within inner_w width.
-inline void render_chips(const std::vector<std::string>& tags, float inner_w) {
+// widths/breaks: precomputed chip widths and line starts (card_layout); when given, no
+// text is measured here.
+inline void render_chips(const std::vector<std::string>& tags, float inner_w,
+                         const std::vector<float>* widths = nullptr, const std::vector<bool>* breaks = nullptr) {
     if (tags.empty()) return;
 
     ImGui::Dummy(ImVec2(1, 2));
+    if (widths && breaks && widths->size() == tags.size() && breaks->size() == tags.size()) {
+        for (size_t i = 0; i < tags.size(); ++i) {
+            if (i != 0 && !(*breaks)[i]) ImGui::SameLine();
+            ImGui::PushID((int)i);
+            chip_sized(tags[i], (*widths)[i]);
+            ImGui::PopID();
+        }
+        return;
+    }
+
     float x0 = ImGui::GetCursorPosX();
     float x = x0;
     float avail = inner_w;
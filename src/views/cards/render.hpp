@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <unordered_map>
 
 #include "../../../vendor/imgui/imgui.h"
 #include "../../parser/parser.hpp"
@@ -13,11 +14,17 @@
 #include "../ui_helpers.hpp"
 #include "items/cover_helpers.hpp"
 #include "items/cover_hover.hpp"
+#include "items/cover_loader.hpp"
 #include "items/meta_row.hpp"
 #include "items/tags_panel.hpp"
+#include "grid_layout.hpp"
+#include "items/card_layout.hpp"
 #include "../../app/settings/settings.hpp"
 #include "../../tags/mod.hpp"
 #include "../../app/settings/helpers/open.hpp"
+#include "../../app/covers.hpp"
+#include "../../app/gallery.hpp"
+#include "../../app/frame_scheduler.hpp"
 
 namespace views {
 namespace cards {
@@ -34,7 +41,25 @@ inline void draw_cover_placeholder(float width) {
     ImGui::Dummy(ImVec2(width, h));
 }
 
-inline void draw_cover(const parser::GameInfo& gi, float width, const app::settings::Config* cfg, const tags::Catalog* cat) {
+// Paint a decoded placeholder hash over [p0, p1] as a grid of gradient quads
+inline void draw_cover_blur(ImDrawList* dl, ImVec2 p0, ImVec2 p1, const app::placeholder::Grid& g) {
+    using app::placeholder::kGridX;
+    using app::placeholder::kGridY;
+    const float cw = (p1.x - p0.x) / (float)kGridX, ch = (p1.y - p0.y) / (float)kGridY;
+    for (int y = 0; y < kGridY; ++y) {
+        for (int x = 0; x < kGridX; ++x) {
+            const ImVec2 a(p0.x + cw * (float)x, p0.y + ch * (float)y);
+            const ImVec2 b(x + 1 == kGridX ? p1.x : a.x + cw, y + 1 == kGridY ? p1.y : a.y + ch);
+            dl->AddRectFilledMultiColor(a, b, g.at(x, y), g.at(x + 1, y), g.at(x + 1, y + 1), g.at(x, y + 1));
+        }
+    }
+}
+
+// vp: viewport of the scrolling grid; covers outside its prefetch window are not requested.
+// Without one the cover is requested whenever it is drawn.
+inline void draw_cover(const parser::GameInfo& gi, float width, const app::settings::Config* cfg, const tags::Catalog* cat,
+                       const items::cover_loader::Viewport* vp = nullptr, const items::card_layout::Layout* layout = nullptr) {
+    if (!layout) layout = &items::card_layout::get(gi, width, cfg, cat);
     const float h = width * 9.0f / 16.0f;
 
     // Make the cover area an interactive item for hover/click handling
@@ -44,14 +69,24 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
     ImVec2 rectMax = ImGui::GetItemRectMax();
     ImDrawList* dl = ImGui::GetWindowDrawList();
 
-    // Cover placeholder
+    // Cover thumbnail once decoded and uploaded; its blurred placeholder (or flat grey) until then
     const float rounding = 6.0f;
-    dl->AddRectFilled(pos, rectMax, IM_COL32(58, 58, 58, 255), rounding);
+    const int prio = vp ? items::cover_loader::priority(*vp, pos.y, rectMax.y) : 0;
+    app::covers::Sprite cover;
+    if (prio != items::cover_loader::kSkip) cover = app::covers::pipeline().sprite(gi.meta.cover, prio);
+    if (cover) {
+        dl->AddImageRounded((ImTextureID)cover.page, pos, rectMax, ImVec2(cover.u0, cover.v0), ImVec2(cover.u1, cover.v1),
+                            IM_COL32(255, 255, 255, 255), rounding);
+    } else if (const app::placeholder::Grid* ph = app::covers::pipeline().placeholder(gi.meta.cover)) {
+        draw_cover_blur(dl, pos, rectMax, *ph);
+    } else {
+        dl->AddRectFilled(pos, rectMax, IM_COL32(58, 58, 58, 255), rounding);
+    }
     dl->AddRect(pos, rectMax, IM_COL32(84, 84, 84, 255), rounding, 0, 2.0f);
 
     // Version badge (top-right)
-    std::string ver = gi.meta.version.empty() ? "v?" : gi.meta.version;
-    ImVec2 txt = ImGui::CalcTextSize(ver.c_str());
+    const std::string& ver = layout->version;
+    const ImVec2 txt = layout->version_size;
     const float pad_x = 6.0f, pad_y = 4.0f;
     const float badge_w = txt.x + 2.0f * pad_x;
     const float badge_h = txt.y + 2.0f * pad_y;
@@ -61,10 +96,10 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
     dl->AddText(ImVec2(badgeMin.x + pad_x, badgeMin.y + pad_y), IM_COL32(255, 255, 255, 255), ver.c_str());
 
     // Engine badge (top-left) if resolvable from prefixes or title
-    if (cat) {
-        std::string engine = views::cards::items::cover_helpers::resolve_engine_name(gi, *cat);
+    {
+        const std::string& engine = layout->engine;
         if (!engine.empty()) {
-            ImVec2 etxt = ImGui::CalcTextSize(engine.c_str());
+            const ImVec2 etxt = layout->engine_size;
             const float epad_x = 6.0f, epad_y = 4.0f;
             const float ebadge_w = etxt.x + 2.0f * epad_x;
             const float ebadge_h = etxt.y + 2.0f * epad_y;
@@ -80,28 +115,42 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
     ImVec2 markersMin = ImVec2(pos.x, rectMax.y - markers_h);
     ImVec2 markersMax = ImVec2(rectMax.x, rectMax.y);
 
-    // Determine number of segments (use links count if available, min 3, max 10)
-    int segments = (int)gi.links.size();
-    segments = segments <= 0 ? 5 : segments;
-    segments = segments > 10 ? 10 : segments;
+    // Determine number of segments: one per screenshot (hover gallery), else per link; max 10.
+    // Links are picked from their own split of the cover width, so a click opens the same
+    // link whether or not the thread has screenshots.
+    auto segment_count = [](std::size_t n) { return n == 0 ? 5 : (n > 10 ? 10 : (int)n); };
+    const int link_segments = segment_count(gi.links.size());
+    const int segments = gi.meta.screens.empty() ? link_segments : segment_count(gi.meta.screens.size());
 
     // Hover detection
     ImVec2 mouse = ImGui::GetIO().MousePos;
     bool over_cover = ImGui::IsItemHovered();
     bool over_markers = (mouse.x >= markersMin.x && mouse.x <= markersMax.x && mouse.y >= markersMin.y && mouse.y <= markersMax.y);
-    int hovered_seg = -1;
+    int hovered_seg = -1, hovered_link = -1;
     if (over_cover || over_markers) {
-        float relx = views::ui_helpers::clamp(mouse.x - pos.x, 0.0f, width);
-        float seg_w = width / (float)segments;
-        hovered_seg = (int)std::floor(relx / seg_w);
-        if (hovered_seg < 0) hovered_seg = 0;
-        if (hovered_seg >= segments) hovered_seg = segments - 1;
+        const float relx = views::ui_helpers::clamp(mouse.x - pos.x, 0.0f, width);
+        auto segment_at = [&](int count) {
+            const int i = (int)std::floor(relx / (width / (float)count));
+            return i < 0 ? 0 : (i >= count ? count - 1 : i);
+        };
+        hovered_seg = segment_at(segments);
+        hovered_link = segment_at(link_segments);
+    }
+
+    // Hover gallery: screenshot N over the cover for segment N, once it is decoded
+    if (hovered_seg >= 0 && !gi.meta.screens.empty()) {
+        app::gallery::gallery().hover(gi.meta.screens, hovered_seg);
+        const std::string& shot = gi.meta.screens[(size_t)(std::min)(hovered_seg, (int)gi.meta.screens.size() - 1)];
+        if (const app::covers::Sprite f = app::gallery::gallery().frame(shot)) {
+            dl->AddImageRounded((ImTextureID)f.page, pos, rectMax, ImVec2(f.u0, f.v0), ImVec2(f.u1, f.v1),
+                                IM_COL32(255, 255, 255, 255), rounding);
+        }
     }
 
-    // If clicked on cover, open hovered segment link
+    // If clicked on cover, open the link under the pointer
     if ((over_cover || over_markers) && ImGui::IsItemClicked() && !gi.links.empty()) {
         int idx = (int)gi.links.size() - 1;
-        if (hovered_seg >= 0) idx = (std::min)(hovered_seg, (int)gi.links.size() - 1);
+        if (hovered_link >= 0) idx = (std::min)(hovered_link, (int)gi.links.size() - 1);
         app::settings::helpers::open::url(gi.links[(size_t)idx].url);
     }
 
@@ -119,6 +168,7 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
     // Thin progress line along the bottom of the cover (indeterminate if no specific progress)
     {
         double t = ImGui::GetTime(); // seconds
+        app::frame_scheduler::scheduler().report_animation(); // moves every frame
         float dp = fmodf((float)(t * 0.35), 1.0f); // slow moving
         float x0 = pos.x;
         float x1 = x0 + width * dp;
@@ -129,16 +179,10 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
     }
 
     // Optional warning count badge (bottom-left) — real logic if cfg/catalog provided, else heuristic
-    int warn_count = 0;
-    if (cfg && cat) {
-        auto wp = views::cards::items::cover_helpers::collect_warnings(gi, *cfg, *cat);
-        warn_count = static_cast<int>(wp.first.size() + wp.second.size());
-    } else {
-        warn_count = (int)gi.meta.tags.size() > 8 ? 1 : 0;
-    }
+    const int warn_count = layout->warn_count;
     if (warn_count > 0) {
-        std::string warn = "!" + std::to_string(warn_count);
-        ImVec2 wtxt = ImGui::CalcTextSize(warn.c_str());
+        const std::string& warn = layout->warn_label;
+        const ImVec2 wtxt = layout->warn_size;
         const float wpad_x = 5.0f, wpad_y = 3.0f;
         ImVec2 wMin = ImVec2(pos.x + (float)ui_constants::kPadding, rectMax.y - (float)ui_constants::kPadding - (wtxt.y + 2.0f * wpad_y));
         ImVec2 wMax = ImVec2(wMin.x + wtxt.x + 2.0f * wpad_x, wMin.y + wtxt.y + 2.0f * wpad_y);
@@ -183,10 +227,13 @@ inline void draw_cover(const parser::GameInfo& gi, float width, const app::setti
 
 // Render a single thread card resembling original layout.
 // width: fixed card width (use ui_constants::kCardWidth).
-inline void draw_thread_card(const parser::GameInfo& gi, float width, const app::settings::Config* cfg, const tags::Catalog* cat) {
+// height: card height; 0 fills the remaining height of the window.
+inline void draw_thread_card(const parser::GameInfo& gi, float width, const app::settings::Config* cfg, const tags::Catalog* cat,
+                             const items::cover_loader::Viewport* vp = nullptr, float height = 0.0f) {
     const float pad = (float)ui_constants::kPadding;
     const float spacing = (float)ui_constants::kSpacing;
     const float inner_w = width - pad * 2.0f;
+    const items::card_layout::Layout& layout = items::card_layout::get(gi, inner_w, cfg, cat);
 
     // Card frame as a child to keep fixed width
     ImGui::BeginGroup();
@@ -195,15 +242,13 @@ inline void draw_thread_card(const parser::GameInfo& gi, float width, const app:
         ImVec2 p0 = ImGui::GetCursorScreenPos();
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(pad, pad));
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(spacing, spacing));
-ImGui::BeginChild((std::string("card##") + gi.meta.title).c_str(), ImVec2(width, 0), true, ImGuiWindowFlags_None);
+ImGui::BeginChild((std::string("card##") + gi.meta.title).c_str(), ImVec2(width, height), true, ImGuiWindowFlags_None);
 
         // Cover at top
-        draw_cover(gi, inner_w, cfg, cat);
+        draw_cover(gi, inner_w, cfg, cat, vp, &layout);
 
-        // Title (wrapped)
-        ImGui::PushTextWrapPos(ImGui::GetCursorPosX() + inner_w);
-        ImGui::TextUnformatted(gi.meta.title.empty() ? "(no title)" : gi.meta.title.c_str());
-        ImGui::PopTextWrapPos();
+        // Title (line breaks precomputed for inner_w)
+        ImGui::TextUnformatted(layout.title.c_str(), layout.title.c_str() + layout.title.size());
 
         // Creator (author) under title
         if (!gi.meta.author.empty()) {
@@ -220,7 +265,7 @@ ImGui::BeginChild((std::string("card##") + gi.meta.title).c_str(), ImVec2(width,
 
         // Tags as chips
         if (!gi.meta.tags.empty()) {
-            items::tags_panel::render_chips(gi.meta.tags, inner_w);
+            items::tags_panel::render_chips(gi.meta.tags, inner_w, &layout.chip_w, &layout.chip_break);
         }
 
         // Links (provider + open)
@@ -248,21 +293,75 @@ ImGui::BeginChild((std::string("card##") + gi.meta.title).c_str(), ImVec2(width,
     ImGui::EndGroup();
 }
 
-// Render a simple grid of cards within current content region.
-// The data source can be a vector of GameInfo if multiple items are present.
-inline void draw_cards_grid(const std::vector<parser::GameInfo>& items, float cardWidth, const app::settings::Config* cfg, const tags::Catalog* cat, float spacing = (float)ui_constants::kSpacing) {
+// Render a virtualized grid of cards within the current (scrolling) window.
+// 'generation' identifies the contents of 'items': callers keep the vector alive across
+// frames and bump it whenever they change the list (the cached row layout is rebuilt then).
+// Rows come from a cached grid layout sized by the per-card layout cache; only rows in the visible area plus
+// kGridRowMargin rows on each side are built, so cost follows the window size rather
+// than the result count. Covers load lazily: cards in or near the visible area request
+// theirs, and rows ahead of the scroll direction that are not built still prefetch.
+inline constexpr int kGridRowMargin = 1;
+
+namespace detail {
+inline std::unordered_map<ImGuiID, grid_layout::Layout>& grid_layouts() {
+    static std::unordered_map<ImGuiID, grid_layout::Layout> m;
+    return m;
+}
+} // namespace detail
+
+inline void draw_cards_grid(const std::vector<parser::GameInfo>& items, std::uint64_t generation, float cardWidth, const app::settings::Config* cfg, const tags::Catalog* cat, float spacing = (float)ui_constants::kSpacing) {
+    const items::cover_loader::Viewport vp = items::cover_loader::track_current_window();
     float avail = ImGui::GetContentRegionAvail().x;
     int cols = (int)(std::max)(1.0f, std::floor((avail + spacing) / (cardWidth + spacing)));
-    int col = 0;
-    for (size_t i = 0; i < items.size(); ++i) {
-        draw_thread_card(items[i], cardWidth, cfg, cat);
-        col++;
-        if (col < cols) {
-            ImGui::SameLine(0.0f, spacing);
-        } else {
-            col = 0;
+    const float cardHeight = (float)ui_constants::kCardHeight;
+
+    grid_layout::Layout& layout = detail::grid_layouts()[ImGui::GetID("##cards_grid")];
+    // Row heights come from the per-card layout cache (at least kCardHeight); rows are
+    // remeasured when the font or warning settings change
+    const float inner_w = cardWidth - 2.0f * (float)ui_constants::kPadding;
+    const std::uint64_t version = items::card_layout::context_key(inner_w, cfg, cat);
+    grid_layout::update(layout, grid_layout::Key{generation, items.size(), cols, cardWidth, spacing, version},
+                        [&](std::size_t i){ return (std::max)(cardHeight, items::card_layout::get(items[i], inner_w, cfg, cat).height); });
+
+    // Grid origin in content and screen space; rows are placed relative to it
+    const float top = ImGui::GetCursorPosY();
+    const float screen_top = ImGui::GetCursorScreenPos().y;
+    const float scroll = ImGui::GetScrollY();
+    const float view_h = ImGui::GetWindowHeight();
+    auto [first, last] = layout.rows_in(scroll - top, scroll - top + view_h);
+    const int built_first = (std::max)(first - kGridRowMargin, 0);
+    const int built_last = (std::min)(last + kGridRowMargin, layout.rows());
+
+    for (int r = built_first; r < built_last; ++r) {
+        ImGui::SetCursorPosY(top + layout.row_top[(std::size_t)r]);
+        const std::size_t begin = (std::size_t)r * (std::size_t)cols;
+        const std::size_t end = (std::min)(items.size(), begin + (std::size_t)cols);
+        for (std::size_t i = begin; i < end; ++i) {
+            if (i != begin) ImGui::SameLine(0.0f, spacing);
+            ImGui::PushID((int)i);
+            draw_thread_card(items[i], cardWidth, cfg, cat, &vp, layout.row_height(r) - (r + 1 < layout.rows() ? spacing : 0.0f));
+            ImGui::PopID();
         }
     }
+
+    // Rows not built but inside the prefetch window still queue their covers
+    const float cover_off = (float)ui_constants::kPadding;
+    const float cover_h = (cardWidth - 2.0f * (float)ui_constants::kPadding) * 9.0f / 16.0f;
+    auto prefetch_row = [&](int r) {
+        const float y0 = screen_top + layout.row_top[(std::size_t)r] + cover_off;
+        const int prio = items::cover_loader::priority(vp, y0, y0 + cover_h);
+        if (prio == items::cover_loader::kSkip) return false;
+        const std::size_t begin = (std::size_t)r * (std::size_t)cols;
+        const std::size_t end = (std::min)(items.size(), begin + (std::size_t)cols);
+        for (std::size_t i = begin; i < end; ++i) app::covers::pipeline().sprite(items[i].meta.cover, prio);
+        return true;
+    };
+    for (int r = built_last; r < layout.rows() && prefetch_row(r); ++r) {}
+    for (int r = built_first - 1; r >= 0 && prefetch_row(r); --r) {}
+
+    // Reserve the full grid height so the scrollbar covers every row
+    ImGui::SetCursorPosY(top + layout.height());
+    ImGui::Dummy(ImVec2(0.0f, 0.0f));
 }
 
 } // namespace cards
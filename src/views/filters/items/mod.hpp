@@ -13,11 +13,14 @@
 
 #include "../../../../vendor/imgui/imgui.h"
 #include "../../../tags/mod.hpp"
+#include "../option_index.hpp"
 
 namespace views {
 namespace filters {
 namespace items {
 
+namespace option_index = ::views::filters::option_index;
+
 // Segmented panel (like a segmented control of mutually-exclusive options)
 namespace segmented_panel {
 inline bool render(const char* id, int& activeIndex, const std::vector<std::string>& segments) {
@@ -144,31 +147,16 @@ inline void render(const tags::Catalog* cat) {
     }
 }
 
- // Picker returning selected tag id (if any)
-inline bool pick(const char* id, const tags::Catalog* cat, std::uint32_t& out_id, const char* placeholder = "(select tag)") {
+ // Picker returning selected tag id (if any); ids in 'selected' are shown as picked
+inline bool pick(const char* id, const tags::Catalog* cat, std::uint32_t& out_id, const char* placeholder = "(select tag)",
+                 const std::vector<std::uint32_t>* selected = nullptr) {
     if (!cat) return false;
-
-    struct Item { std::uint32_t id; std::string name; };
-    std::vector<Item> items;
-    items.reserve(cat->tags.size());
-    for (const auto& kv : cat->tags) {
-        items.push_back(Item{ static_cast<std::uint32_t>(kv.first), kv.second });
-    }
-    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b){ return a.name < b.name; });
-
-    bool chosen = false;
-    const char* label = id ? id : "##tags_picker";
-    const char* preview = (placeholder && *placeholder) ? placeholder : "(none)";
-    if (ImGui::BeginCombo(label, preview)) {
-        for (const auto& it : items) {
-            const bool selected = false;
-            if (ImGui::Selectable(it.name.c_str(), selected)) {
-                out_id = it.id;
-                chosen = true;
-            }
-        }
-        ImGui::EndCombo();
-    }
+    const auto& ix = option_index::tags_for(*cat);
+    const tags::Bitset sel = selected ? option_index::selection(ix, *selected) : tags::Bitset{};
+    int picked = 0;
+    const bool chosen = option_index::combo(id ? id : "##tags_picker", ix, sel, picked,
+                                            (placeholder && *placeholder) ? placeholder : "(none)");
+    if (chosen) out_id = static_cast<std::uint32_t>(picked);
     return chosen;
 }
 } // namespace tags_menu
@@ -198,38 +186,16 @@ inline void render(const tags::Catalog* cat) {
     render_group("Assets", cat->assets);
 }
 
- // Picker returning selected prefix id (if any)
-inline bool pick(const char* id, const tags::Catalog* cat, std::uint32_t& out_id, const char* placeholder = "(select prefix)") {
+ // Picker returning selected prefix id (if any); ids in 'selected' are shown as picked
+inline bool pick(const char* id, const tags::Catalog* cat, std::uint32_t& out_id, const char* placeholder = "(select prefix)",
+                 const std::vector<std::uint32_t>* selected = nullptr) {
     if (!cat) return false;
-
-    struct Item { std::uint32_t id; std::string name; };
-    std::vector<Item> items;
-    auto emit = [&](const char* cat_name, const std::vector<tags::Group>& groups) {
-        for (const auto& g : groups) {
-            for (const auto& p : g.prefixes) {
-                items.push_back(Item{ static_cast<std::uint32_t>(p.id), std::string(cat_name) + ": " + p.name });
-            }
-        }
-    };
-    emit("Games", cat->games);
-    emit("Comics", cat->comics);
-    emit("Animations", cat->animations);
-    emit("Assets", cat->assets);
-    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b){ return a.name < b.name; });
-
-    bool chosen = false;
-    const char* label = id ? id : "##prefixes_picker";
-    const char* preview = (placeholder && *placeholder) ? placeholder : "(none)";
-    if (ImGui::BeginCombo(label, preview)) {
-        for (const auto& it : items) {
-            const bool selected = false;
-            if (ImGui::Selectable(it.name.c_str(), selected)) {
-                out_id = it.id;
-                chosen = true;
-            }
-        }
-        ImGui::EndCombo();
-    }
+    const auto& ix = option_index::prefixes_for(*cat);
+    const tags::Bitset sel = selected ? option_index::selection(ix, *selected) : tags::Bitset{};
+    int picked = 0;
+    const bool chosen = option_index::combo(id ? id : "##prefixes_picker", ix, sel, picked,
+                                            (placeholder && *placeholder) ? placeholder : "(none)");
+    if (chosen) out_id = static_cast<std::uint32_t>(picked);
     return chosen;
 }
 } // namespace prefixes_menu
@@ -0,0 +1,251 @@
+#pragma once
+// Purpose: Sorted, searchable option lists for the tag and prefix filter menus.
+// Built once per catalog load. Type-ahead search narrows the previous result set when the
+// query grows, and otherwise starts from the shortest trigram posting list, so typing costs
+// O(matches). Selection state is a bitset over option positions; the combo emits only the
+// rows in view (ImGuiListClipper). Catalog ids are not unique across prefix categories
+// (e.g. "Completed" exists under Games and Comics with the same id), so an id maps to every
+// position carrying it.
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "../../../vendor/imgui/imgui.h"
+#include "../../tags/mod.hpp"
+#include "../../tags/index.hpp"
+
+namespace views {
+namespace filters {
+namespace option_index {
+
+struct Option {
+    int id = 0;         // catalog id
+    std::string label;  // shown in the menu and on chips
+    std::string folded; // lowercase label, for matching
+};
+
+class Index {
+public:
+    std::vector<Option> options; // sorted by label
+    std::size_t generation = 0;  // changes whenever the index is rebuilt
+
+    // First position (in label order) of catalog id 'id' in options, -1 if absent
+    int position(int id) const {
+        auto it = by_id_.find(id);
+        return it == by_id_.end() ? -1 : it->second.front();
+    }
+    // All positions of catalog id 'id'; nullptr if absent
+    const std::vector<int>* positions(int id) const {
+        auto it = by_id_.find(id);
+        return it == by_id_.end() ? nullptr : &it->second;
+    }
+    const std::string* label(int id) const {
+        const int p = position(id);
+        return p < 0 ? nullptr : &options[(std::size_t)p].label;
+    }
+
+    // Options are appended unsorted, then finish() sorts them and builds the lookups
+    void add(int id, std::string label) {
+        Option o;
+        o.id = id;
+        o.folded = tags::fold(label);
+        o.label = std::move(label);
+        options.push_back(std::move(o));
+    }
+    void finish() {
+        std::stable_sort(options.begin(), options.end(), [](const Option& a, const Option& b){ return a.label < b.label; });
+        by_id_.clear();
+        trigrams_.clear();
+        for (int p = 0; p < (int)options.size(); ++p) {
+            by_id_[options[(std::size_t)p].id].push_back(p);
+            const std::string& f = options[(std::size_t)p].folded;
+            for (std::size_t i = 0; i + 3 <= f.size(); ++i) {
+                auto& list = trigrams_[trigram(f, i)];
+                if (list.empty() || list.back() != p) list.push_back(p);
+            }
+        }
+    }
+
+    // Candidates for 'folded_query' (length >= 3): the shortest posting list among its
+    // trigrams, nullptr if some trigram occurs nowhere.
+    const std::vector<int>* candidates(const std::string& folded_query) const {
+        const std::vector<int>* best = nullptr;
+        for (std::size_t i = 0; i + 3 <= folded_query.size(); ++i) {
+            auto it = trigrams_.find(trigram(folded_query, i));
+            if (it == trigrams_.end()) return nullptr;
+            if (!best || it->second.size() < best->size()) best = &it->second;
+        }
+        return best;
+    }
+
+private:
+    static std::uint32_t trigram(const std::string& s, std::size_t i) {
+        return (std::uint32_t)(unsigned char)s[i] << 16 | (std::uint32_t)(unsigned char)s[i + 1] << 8 |
+               (std::uint32_t)(unsigned char)s[i + 2];
+    }
+
+    std::unordered_map<int, std::vector<int>> by_id_;
+    std::unordered_map<std::uint32_t, std::vector<int>> trigrams_;
+};
+
+// Per-menu search state: the query and the positions matching it. Label-prefix matches
+// come first, then other substring matches, each in label order.
+struct Search {
+    std::string input; // as typed
+    std::string query; // folded
+    std::vector<int> results;
+    const Index* index = nullptr;
+    std::size_t generation = 0;
+};
+
+namespace detail {
+inline void finish_results(const Index& ix, const std::string& q, const std::vector<int>& in, std::vector<int>& out) {
+    std::vector<int> rest;
+    out.clear();
+    for (int p : in) {
+        const std::size_t at = ix.options[(std::size_t)p].folded.find(q);
+        if (at == 0) out.push_back(p);
+        else if (at != std::string::npos) rest.push_back(p);
+    }
+    out.insert(out.end(), rest.begin(), rest.end());
+}
+} // namespace detail
+
+// Bring s.results up to date for 'input'
+inline void update(const Index& ix, Search& s, const std::string& input) {
+    const std::string q = tags::fold(input);
+    s.input = input;
+    const bool fresh = s.index != &ix || s.generation != ix.generation;
+    if (!fresh && q == s.query) return;
+    const bool narrows = !fresh && !s.query.empty() && q.size() > s.query.size() && q.compare(0, s.query.size(), s.query) == 0;
+    std::vector<int> next;
+    if (q.empty()) {
+        next.resize(ix.options.size());
+        for (std::size_t p = 0; p < next.size(); ++p) next[p] = (int)p;
+    } else if (narrows) {
+        // Filtering keeps the prefix-first order: a prefix match of q was one of s.query
+        detail::finish_results(ix, q, s.results, next);
+    } else if (q.size() >= 3) {
+        if (const auto* c = ix.candidates(q)) detail::finish_results(ix, q, *c, next);
+    } else {
+        std::vector<int> all(ix.options.size());
+        for (std::size_t p = 0; p < all.size(); ++p) all[p] = (int)p;
+        detail::finish_results(ix, q, all, next);
+    }
+    s.results = std::move(next);
+    s.query = q;
+    s.index = &ix;
+    s.generation = ix.generation;
+}
+
+// Selected catalog ids as a bitset over option positions (every position of each id)
+template <class Ids>
+inline tags::Bitset selection(const Index& ix, const Ids& ids) {
+    tags::Bitset b;
+    for (auto id : ids) {
+        if (const std::vector<int>* ps = ix.positions((int)id)) {
+            for (int p : *ps) b.set(p);
+        }
+    }
+    return b;
+}
+
+namespace detail {
+struct Cached {
+    Index index;
+    const tags::Catalog* source = nullptr;
+    std::size_t shape = 0;
+};
+
+inline const Index& cached(Cached& c, const tags::Catalog& cat, void (*build)(const tags::Catalog&, Index&)) {
+    const std::size_t s = tags::catalog_shape(cat);
+    if (c.source != &cat || c.shape != s || c.index.generation == 0) {
+        const std::size_t gen = c.index.generation + 1;
+        c.index = Index{};
+        build(cat, c.index);
+        c.index.finish();
+        c.index.generation = gen;
+        c.source = &cat;
+        c.shape = s;
+    }
+    return c.index;
+}
+
+inline Cached& tag_cache() { static Cached c; return c; }
+inline Cached& prefix_cache() { static Cached c; return c; }
+
+inline std::unordered_map<ImGuiID, Search>& searches() {
+    static std::unordered_map<ImGuiID, Search> m;
+    return m;
+}
+} // namespace detail
+
+// Tag options ("name"), rebuilt when the catalog is reloaded. UI thread only.
+inline const Index& tags_for(const tags::Catalog& cat) {
+    return detail::cached(detail::tag_cache(), cat, [](const tags::Catalog& c, Index& ix) {
+        ix.options.reserve(c.tags.size());
+        for (const auto& [id, name] : c.tags) ix.add(id, name);
+    });
+}
+
+// Prefix options ("Category: name"), rebuilt when the catalog is reloaded. UI thread only.
+inline const Index& prefixes_for(const tags::Catalog& cat) {
+    return detail::cached(detail::prefix_cache(), cat, [](const tags::Catalog& c, Index& ix) {
+        auto add = [&](const char* cat_name, const std::vector<tags::Group>& groups) {
+            for (const auto& g : groups) {
+                for (const auto& p : g.prefixes) ix.add(p.id, std::string(cat_name) + ": " + p.name);
+            }
+        };
+        add("Games", c.games);
+        add("Comics", c.comics);
+        add("Animations", c.animations);
+        add("Assets", c.assets);
+    });
+}
+
+// Combo with a type-ahead box over 'ix'. Selected options are highlighted and cannot be
+// picked again. Returns true and sets out_id when an option is chosen.
+inline bool combo(const char* id, const Index& ix, const tags::Bitset& selected, int& out_id, const char* placeholder) {
+    bool chosen = false;
+    if (!ImGui::BeginCombo(id, placeholder, ImGuiComboFlags_HeightLarge)) return false;
+
+    Search& s = detail::searches()[ImGui::GetID("##option_search")];
+    if (ImGui::IsWindowAppearing()) {
+        s.input.clear();
+        ImGui::SetKeyboardFocusHere();
+    }
+    char buf[128];
+    const std::size_t n = (std::min)(s.input.size(), sizeof(buf) - 1);
+    std::memcpy(buf, s.input.data(), n);
+    buf[n] = '\0';
+    ImGui::SetNextItemWidth(-1.0f);
+    ImGui::InputTextWithHint("##option_filter", "Type to search...", buf, sizeof(buf));
+    update(ix, s, buf);
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)s.results.size());
+    while (clipper.Step()) {
+        for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+            const int p = s.results[(std::size_t)r];
+            const Option& o = ix.options[(std::size_t)p];
+            const bool is_selected = selected.test(p);
+            ImGui::PushID(p);
+            if (ImGui::Selectable(o.label.c_str(), is_selected) && !is_selected) {
+                out_id = o.id;
+                chosen = true;
+            }
+            ImGui::PopID();
+        }
+    }
+    clipper.End();
+    ImGui::EndCombo();
+    return chosen;
+}
+
+} // namespace option_index
+} // namespace filters
+} // namespace views
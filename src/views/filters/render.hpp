@@ -141,7 +141,7 @@ inline Events draw_filters_panel(const RenderOptions& opts, Model& model, const
         }
         {
             std::uint32_t picked = 0;
-            if (tags_menu::pick("include_tags", catalog, picked, "Select tag to include")) {
+            if (tags_menu::pick("include_tags", catalog, picked, "Select tag to include", &model.include_tags)) {
                 auto& v = model.include_tags;
                 if ((int)v.size() < ui_constants::kMaxFilterItems &&
                     std::find(v.begin(), v.end(), picked) == v.end()) {
@@ -158,7 +158,7 @@ inline Events draw_filters_panel(const RenderOptions& opts, Model& model, const
         ImGui::SeparatorText("Tags (exclude)");
         {
             std::uint32_t picked = 0;
-            if (tags_menu::pick("exclude_tags", catalog, picked, "Select tag to exclude")) {
+            if (tags_menu::pick("exclude_tags", catalog, picked, "Select tag to exclude", &model.exclude_tags)) {
                 auto& v = model.exclude_tags;
                 if ((int)v.size() < ui_constants::kMaxFilterItems &&
                     std::find(v.begin(), v.end(), picked) == v.end()) {
@@ -175,7 +175,7 @@ inline Events draw_filters_panel(const RenderOptions& opts, Model& model, const
         ImGui::SeparatorText("Prefixes (include)");
         {
             std::uint32_t picked = 0;
-            if (prefixes_menu::pick("include_prefixes", catalog, picked, "Select prefix to include")) {
+            if (prefixes_menu::pick("include_prefixes", catalog, picked, "Select prefix to include", &model.include_prefixes)) {
                 auto& v = model.include_prefixes;
                 if ((int)v.size() < ui_constants::kMaxFilterItems &&
                     std::find(v.begin(), v.end(), picked) == v.end()) {
@@ -191,7 +191,7 @@ inline Events draw_filters_panel(const RenderOptions& opts, Model& model, const
         ImGui::SeparatorText("Prefixes (exclude)");
         {
             std::uint32_t picked = 0;
-            if (prefixes_menu::pick("exclude_prefixes", catalog, picked, "Select prefix to exclude")) {
+            if (prefixes_menu::pick("exclude_prefixes", catalog, picked, "Select prefix to exclude", &model.exclude_prefixes)) {
                 auto& v = model.exclude_prefixes;
                 if ((int)v.size() < ui_constants::kMaxFilterItems &&
                     std::find(v.begin(), v.end(), picked) == v.end()) {
@@ -0,0 +1,4 @@
+#pragma once
+// Purpose: Aggregate logs view module.
+
+#include "render.hpp"
@@ -0,0 +1,30 @@
+#pragma once
+// Purpose: Log lines panel of the Logs tab (scrolling child with the logger buffer).
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "../../../vendor/imgui/imgui.h"
+#include "../../logger.hpp"
+
+namespace views {
+namespace logs {
+
+// Draw the current log lines in a scrolling child filling the remaining space.
+// With 'autoscroll', the view follows new lines; prev_count tracks the last line count.
+inline void draw_log_lines(bool autoscroll, std::size_t& prev_count) {
+    ImGui::BeginChild("logs_scroll", ImVec2(0, 0), true, ImGuiWindowFlags_HorizontalScrollbar);
+    auto lines = logger::lines();
+    for (auto& s : lines) {
+        ImGui::TextUnformatted(s.c_str());
+    }
+    if (autoscroll && lines.size() > prev_count) {
+        ImGui::SetScrollHereY(1.0f);
+    }
+    prev_count = lines.size();
+    ImGui::EndChild();
+}
+
+} // namespace logs
+} // namespace views
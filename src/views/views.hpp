@@ -5,6 +5,7 @@
 
 #include "cards/mod.hpp"
 #include "filters/mod.hpp"
+#include "logs/mod.hpp"
 
 namespace views {
 
@@ -40,11 +41,12 @@ inline void render_thread_card(const ::parser::GameInfo& gi,
 }
 
 inline void render_cards_grid(const std::vector<::parser::GameInfo>& items,
+                              std::uint64_t generation,
                               float cardWidth,
                               const ::app::settings::Config* cfg,
                               const ::tags::Catalog* cat,
                               float spacing) {
-    ::views::cards::draw_cards_grid(items, cardWidth, cfg, cat, spacing);
+    ::views::cards::draw_cards_grid(items, generation, cardWidth, cfg, cat, spacing);
 }
 
 } // namespace views